@@ -5,8 +5,7 @@
 
 class Admin : public IUser {
 public:
-    Admin(const std::string& user, const std::string& hash) : IUser(user, hash) {}
-    std::string getRole() const override { return "admin"; }
+    Admin(const std::string& user, const std::string& hash) : IUser(user, hash, UserRole::Admin) {}
 };
 
 #endif
\ No newline at end of file
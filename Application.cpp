@@ -2,6 +2,7 @@
 #include <iostream>
 #include <sstream>
 #include "ScholarshipType.h" 
+#include "FieldTokenizer.h"
 
 int Application::nextId = 1;
 
@@ -11,42 +12,40 @@ Application::Application(const std::string& user, double avg,
     status(st), scholarshipCategory(category) {
 
     if (studentUsername.empty()) {
-        throw std::invalid_argument("     ");
+        throw std::invalid_argument("Имя пользователя не может быть пустым");
     }
     if (avg < 0.0 || avg > 10.0) {
-        throw std::invalid_argument("     0.0  10.0");
+        throw std::invalid_argument("Средний балл должен быть от 0.0 до 10.0");
     }
 }
 
 std::ostream& operator<<(std::ostream& os, const Application& app) {
     os << "ID: " << app.getId()
-        << ", : " << app.getStudentUsername()
-        << ",  : " << app.getAverageGrade()
-        << ",  : " << ScholarshipType::categoryToString(app.getScholarshipCategory())
-        << ", : ";
+        << ", Студент: " << app.getStudentUsername()
+        << ", Средний балл: " << app.getAverageGrade()
+        << ", Тип стипендии: " << ScholarshipType::categoryToString(app.getScholarshipCategory())
+        << ", Статус: ";
     switch (app.getStatus()) {
-    case ApplicationStatus::Pending: os << ""; break;
-    case ApplicationStatus::Approved: os << ""; break;
-    case ApplicationStatus::Rejected: os << ""; break;
+    case ApplicationStatus::Pending: os << "Ожидание"; break;
+    case ApplicationStatus::Approved: os << "Одобрено"; break;
+    case ApplicationStatus::Rejected: os << "Отклонено"; break;
     }
     return os;
 }
 
-bool Application::loadFromString(const std::string& str) {
-    std::stringstream ss(str);
-    char delimiter;
-
-    ss >> id >> delimiter;
-    if (delimiter != '|') return false;
-
-    std::getline(ss, studentUsername, '|');
-    ss >> averageGrade >> delimiter;
-    if (delimiter != '|') return false;
-
+bool Application::loadFromString(std::string_view str, std::string* error) {
+    // Формат: id|логин|балл|категория|статус
+    FieldTokenizer fields(str, '|');
     int categoryInt, statusInt;
-    ss >> categoryInt >> delimiter;
-    if (delimiter != '|') return false;
-    ss >> statusInt;
+
+    if (!fields.nextInt(id, "ID") ||
+        !fields.nextString(studentUsername, "логин") ||
+        !fields.nextDouble(averageGrade, "средний балл") ||
+        !fields.nextInt(categoryInt, "категория") ||
+        !fields.nextInt(statusInt, "статус")) {
+        if (error) *error = fields.error();
+        return false;
+    }
 
     scholarshipCategory = static_cast<ScholarshipCategory>(categoryInt);
     status = static_cast<ApplicationStatus>(statusInt);
@@ -65,4 +64,15 @@ std::string Application::saveToString() const {
 }
 void Application::setNextId(int id) {
     nextId = id;
+}
+
+Application Application::restore(int id, std::string user, double avg,
+    ScholarshipCategory category, ApplicationStatus st) {
+    Application app;
+    app.id = id;
+    app.studentUsername = std::move(user);
+    app.averageGrade = avg;
+    app.scholarshipCategory = category;
+    app.status = st;
+    return app;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define APPLICATION_H
 
 #include <string>
+#include <string_view>
 #include "ScholarshipType.h" 
 
 enum class ApplicationStatus { Pending = 0, Approved = 1, Rejected = 2 };
@@ -23,7 +24,7 @@ public:
 
    
     int getId() const { return id; }
-    std::string getStudentUsername() const { return studentUsername; }
+    const std::string& getStudentUsername() const { return studentUsername; }
     double getAverageGrade() const { return averageGrade; }
     ApplicationStatus getStatus() const { return status; }
     ScholarshipCategory getScholarshipCategory() const { return scholarshipCategory; }
@@ -33,7 +34,8 @@ public:
     void setScholarshipCategory(ScholarshipCategory category) { scholarshipCategory = category; }
 
    
-    bool loadFromString(const std::string& str);
+    // При ошибке разбора описание пишется в error (если передан)
+    bool loadFromString(std::string_view str, std::string* error = nullptr);
     std::string saveToString() const;
 
 
@@ -49,7 +51,11 @@ public:
 
     friend std::ostream& operator<<(std::ostream& os, const Application& app);
 
-    //     ID
+    // Восстановление заявки с известным ID (без выдачи нового ID и проверок)
+    static Application restore(int id, std::string user, double avg,
+        ScholarshipCategory category, ApplicationStatus st);
+
+    // Статические методы для управления ID
     static void resetIdCounter() { nextId = 1; }
     static void setNextId(int id); 
 };
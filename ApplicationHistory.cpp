@@ -1,66 +1,1053 @@
 #include "ApplicationHistory.h"
 #include "FileManager.h"
+#include "FieldTokenizer.h"
+#include "HistoryArchive.h"
+#include "Logger.h"
+#include "Utils.h"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <fstream> 
+#include <filesystem>
+#include <map>
+#include <chrono>
 
 ApplicationHistory::ApplicationHistory(const std::string& filename)
-    : historyFile(filename) {
+    : historyFile(filename), firstLoadedSegment(0), unloadedRecords(0),
+    sealedRecords(0), activeStart(0), segmentLimit(100000),
+    archiveAge(static_cast<std::time_t>(365) * 24 * 60 * 60),
+    syncPolicy(SyncPolicy::Always), syncInterval(16),
+    compactionThreshold(1000), journalCount(0), unsyncedCount(0),
+    writer(nullptr), journalBufferSync(false), journalWriteFailed(false), batchDepth(0), batchStart(0) {
+    journalFile = std::filesystem::path(filename).replace_extension(".journal").string();
+    manifestFile = std::filesystem::path(filename).replace_extension(".manifest").string();
     loadFromFile();
 }
 
+ApplicationHistory::~ApplicationHistory() {
+    // Задачи writer обращаются к буферу журнала этого объекта; строки,
+    // которые writer не смог записать, пробуем дописать последний раз
+    if (!flushWriter() && !drainJournal()) {
+        LOG_ERROR("ApplicationHistory", "Строки журнала " << journalFile << " не записаны");
+    }
+}
+
+void ApplicationHistory::setWriter(BackgroundWriter* backgroundWriter) {
+    if (!flushWriter() && !drainJournal()) {
+        LOG_ERROR("ApplicationHistory", "Строки журнала " << journalFile << " не записаны");
+    }
+    writer = backgroundWriter;
+}
+
+namespace {
+    // Общий словарь строк истории; строка с идентификатором 0 - пустая
+    struct HistorySymbols {
+        StringDictionary dictionary;
+        std::shared_mutex mutex;
+        HistorySymbols() { dictionary.intern(""); }
+    };
+
+    HistorySymbols& historySymbols() {
+        static HistorySymbols symbols;
+        return symbols;
+    }
+
+    const char* SNAPSHOT_HEADER = "#HISTORY 2";
+    const char* MANIFEST_HEADER = "#SEGMENTS";
+
+    // Номер месяца по местному времени - граница сегментов
+    int monthKey(std::time_t timestamp) {
+        struct tm timeinfo;
+        localtime_s(&timeinfo, &timestamp);
+        return (timeinfo.tm_year + 1900) * 12 + timeinfo.tm_mon;
+    }
+
+    bool isArchiveFile(const std::string& name) {
+        return std::filesystem::path(name).extension() == ".arc";
+    }
+}
+
+uint32_t HistoryRecord::intern(std::string_view s) {
+    if (s.empty()) return 0;
+    HistorySymbols& symbols = historySymbols();
+    {
+        std::shared_lock<std::shared_mutex> lock(symbols.mutex);
+        uint32_t id = symbols.dictionary.find(s);
+        if (id != StringDictionary::NOT_FOUND) return id;
+    }
+    std::unique_lock<std::shared_mutex> lock(symbols.mutex);
+    return symbols.dictionary.intern(s);
+}
+
+uint32_t HistoryRecord::findSymbol(std::string_view s) {
+    HistorySymbols& symbols = historySymbols();
+    std::shared_lock<std::shared_mutex> lock(symbols.mutex);
+    return symbols.dictionary.find(s);
+}
+
+const std::string& HistoryRecord::symbol(uint32_t id) {
+    // Строки словаря не перемещаются, ссылка остаётся верной и после блокировки
+    HistorySymbols& symbols = historySymbols();
+    std::shared_lock<std::shared_mutex> lock(symbols.mutex);
+    return symbols.dictionary.str(id);
+}
+
+size_t HistoryRecord::symbolCount() {
+    HistorySymbols& symbols = historySymbols();
+    std::shared_lock<std::shared_mutex> lock(symbols.mutex);
+    return symbols.dictionary.size();
+}
+
+std::string ApplicationHistory::formatRecord(const HistoryRecord& record) {
+    std::stringstream ss;
+    ss << record.applicationId << "|"
+        << record.getStudentUsername() << "|"
+        << record.getScholarshipType() << "|"
+        << static_cast<int>(record.action) << "|"
+        << record.getAdminUsername() << "|"
+        << record.getComment() << "|"
+        << record.timestamp;
+    return ss.str();
+}
+
+bool ApplicationHistory::parseRecord(FieldTokenizer& fields, HistoryRecord& record) {
+    int action;
+    long long timestamp;
+    std::string_view student, scholarship, admin, comment;
+    if (!fields.nextInt(record.applicationId, "ID заявки") ||
+        !fields.next(student, "студент") ||
+        !fields.next(scholarship, "стипендия") ||
+        !fields.nextIntInRange(action, 0, static_cast<int>(HISTORY_ACTION_COUNT), "действие") ||
+        !fields.next(admin, "администратор") ||
+        !fields.next(comment, "комментарий") ||
+        !fields.nextInt64(timestamp, "время")) {
+        return false;
+    }
+    record.setStudentUsername(student);
+    record.setScholarshipType(scholarship);
+    record.action = static_cast<HistoryAction>(action);
+    record.setAdminUsername(admin);
+    record.setComment(comment);
+    record.timestamp = static_cast<std::time_t>(timestamp);
+    return true;
+}
+
+bool ApplicationHistory::parseEncodedRecord(FieldTokenizer& fields,
+    const std::vector<uint32_t>& symbols, HistoryRecord& record) {
+    long long student, scholarship, admin, comment, timestamp;
+    int action;
+    if (!fields.nextInt(record.applicationId, "ID заявки") ||
+        !fields.nextInt64(student, "студент") ||
+        !fields.nextInt64(scholarship, "стипендия") ||
+        !fields.nextIntInRange(action, 0, static_cast<int>(HISTORY_ACTION_COUNT), "действие") ||
+        !fields.nextInt64(admin, "администратор") ||
+        !fields.nextInt64(comment, "комментарий") ||
+        !fields.nextInt64(timestamp, "время")) {
+        return false;
+    }
+
+    long long count = static_cast<long long>(symbols.size());
+    for (long long id : { student, scholarship, admin, comment }) {
+        if (id < 0 || id >= count) return false;
+    }
+    record.studentId = symbols[student];
+    record.scholarshipTypeId = symbols[scholarship];
+    record.action = static_cast<HistoryAction>(action);
+    record.adminId = symbols[admin];
+    record.commentId = symbols[comment];
+    record.timestamp = static_cast<std::time_t>(timestamp);
+    return true;
+}
+
+bool ApplicationHistory::readSnapshot(const std::string& filename,
+    std::vector<HistoryRecord>& out, long long& base) {
+    // Строки читаются из отображённого файла и разбираются без копирования.
+    // Снимок версии 2: заголовок, номер первой записи в истории ("#BASE n"),
+    // словарь ("#DICT n" и n строк, строка i получает локальный номер i,
+    // 0 - пустая строка), затем "#RECORDS m" и записи с номерами строк вместо
+    // самих строк. Без заголовка - старый формат, где строки записаны в
+    // каждой записи.
+    enum class Section { Legacy, Header, Dictionary, Records };
+    Section section = Section::Legacy;
+    std::vector<uint32_t> symbols;   // локальный номер -> идентификатор словаря
+    size_t dictionaryLeft = 0;
+    base = 0;
+
+    return FileManager::forEachLine(filename, [&](std::string_view line, size_t lineNumber) {
+        if (lineNumber == 1 && line == SNAPSHOT_HEADER) {
+            section = Section::Header;
+            return;
+        }
+
+        if (section == Section::Dictionary && dictionaryLeft > 0) {
+            symbols.push_back(HistoryRecord::intern(line));
+            if (--dictionaryLeft == 0) section = Section::Header;
+            return;
+        }
+
+        if (section == Section::Header) {
+            FieldTokenizer fields(line, ' ');
+            std::string_view tag;
+            long long count = 0;
+            if (fields.next(tag, "раздел") && fields.nextInt64(count, "размер") && count >= 0) {
+                if (tag == "#BASE") {
+                    base = count;
+                    return;
+                }
+                if (tag == "#DICT") {
+                    symbols.assign(1, 0);
+                    symbols.reserve(static_cast<size_t>(count) + 1);
+                    dictionaryLeft = static_cast<size_t>(count);
+                    section = dictionaryLeft > 0 ? Section::Dictionary : Section::Header;
+                    return;
+                }
+                if (tag == "#RECORDS") {
+                    out.reserve(out.size() + static_cast<size_t>(count));
+                    section = Section::Records;
+                    return;
+                }
+            }
+            LOG_WARN("ApplicationHistory", "Ошибка разбора " << filename << ", строка " << lineNumber
+                << ": неизвестный раздел. Строка пропущена");
+            return;
+        }
+
+        FieldTokenizer fields(line, '|');
+        HistoryRecord record;
+        bool parsed = section == Section::Records
+            ? parseEncodedRecord(fields, symbols, record)
+            : parseRecord(fields, record);
+        if (!parsed) {
+            std::string error = fields.error().empty() ? "неизвестный номер строки словаря" : fields.error();
+            LOG_WARN("ApplicationHistory", "Ошибка разбора " << filename << ", строка " << lineNumber
+                << ": " << error << ". Запись пропущена");
+            return;
+        }
+        out.push_back(record);
+        });
+}
+
 void ApplicationHistory::loadFromFile() {
+    auto started = std::chrono::steady_clock::now();
     records.clear();
-    auto lines = FileManager::readLines(historyFile);
+    activeStart = 0;
+    loadManifest();
+
+    // При старте читается только активный сегмент
+    long long base = 0;
+    readSnapshot(historyFile, records, base);
+
+    // Журнал: "порядковый номер в активном сегменте|запись". Записи с номером
+    // меньше размера снимка уже попали в него при свёртке, прерванной до
+    // удаления журнала.
+    auto journal = FileManager::readJournal(journalFile);
+    journalCount = 0;
+
+    for (size_t i = 0; i < journal.size(); ++i) {
+        FieldTokenizer fields(journal[i], '|');
+        HistoryRecord record;
+        long long seq;
+        if (!fields.nextInt64(seq, "номер") || !parseRecord(fields, record)) {
+            LOG_WARN("ApplicationHistory", "Ошибка разбора " << journalFile << ", строка " << (i + 1)
+                << ": " << fields.error() << ". Запись пропущена");
+            continue;
+        }
+        if (seq < static_cast<long long>(records.size())) continue;
+
+        records.push_back(record);
+        journalCount++;
+    }
+
+    // Файлы старых версий могли хранить записи не по порядку времени
+    auto byTime = [](const HistoryRecord& a, const HistoryRecord& b) {
+        return a.timestamp < b.timestamp;
+    };
+    if (!std::is_sorted(records.begin(), records.end(), byTime)) {
+        std::stable_sort(records.begin(), records.end(), byTime);
+    }
+
+    // Сбой между записью манифеста и сохранением активного снимка: начало
+    // активного сегмента уже закрыто в отдельный файл
+    size_t skipped = 0;
+    if (base >= 0 && static_cast<size_t>(base) < sealedRecords) {
+        skipped = std::min(sealedRecords - static_cast<size_t>(base), records.size());
+        records.erase(records.begin(), records.begin() + skipped);
+    }
+
+    rebuildIndex();
+    invalidateSnapshot();
+
+    if (needsRotation()) {
+        // Месяц сменился, пока программа не работала, или это файл старой
+        // версии со всей историей: лишнее закрывается в сегменты
+        rotateSegments();
+    }
+    else if (skipped > 0) {
+        // Номера в журнале считаются от старого начала сегмента
+        compact();
+    }
+    archiveSegments();
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+    LOG_INFO("ApplicationHistory", "История загружена: active=" << records.size()
+        << " journal=" << journalCount << " segments=" << segments.size()
+        << " unloaded=" << unloadedRecords << " ms=" << ms);
+}
+
+void ApplicationHistory::loadManifest() {
+    segments.clear();
+    sealedRecords = 0;
+    unloadedActionCounts.fill(0);
+
+    // Манифест: заголовок и по строке на сегмент
+    // "файл|первое время|последнее время|записей|по действиям...|студентов|администраторов",
+    // за ней строки "+S|логин|записей" по студентам и "+A|логин|записей" по администраторам
+    std::vector<std::pair<int, int>> declared;   // заявленные размеры списков сегментов
+    bool segmentSkipped = false;
+    if (std::filesystem::exists(manifestFile)) {
+        FileManager::forEachLine(manifestFile, [&](std::string_view line, size_t lineNumber) {
+            if (line.front() == '#') return;
+
+            if (line.front() == '+') {
+                // Участники пропущенного сегмента не относятся к предыдущему
+                if (segments.empty() || segmentSkipped) return;
+                FieldTokenizer fields(line.substr(1), '|');
+                std::string_view kind, login;
+                int count;
+                if (!fields.next(kind, "вид") || !fields.next(login, "логин") ||
+                    !fields.nextInt(count, "записей") || count < 0 || (kind != "S" && kind != "A")) {
+                    LOG_WARN("ApplicationHistory", "Ошибка разбора " << manifestFile << ", строка " << lineNumber
+                        << ": " << fields.error() << ". Участники сегмента будут пересчитаны");
+                    declared.back() = { -1, -1 };
+                    return;
+                }
+                auto& list = kind == "S" ? segments.back().students : segments.back().admins;
+                list.emplace_back(HistoryRecord::intern(login), count);
+                return;
+            }
+
+            FieldTokenizer fields(line, '|');
+            Segment segment;
+            std::string_view name;
+            long long from, to, count;
+            bool parsed = fields.next(name, "файл") &&
+                fields.nextInt64(from, "начало") &&
+                fields.nextInt64(to, "конец") &&
+                fields.nextInt64(count, "записей") && count >= 0;
+            for (auto& actions : segment.actions) {
+                parsed = parsed && fields.nextInt(actions, "действие");
+            }
+            std::pair<int, int> lists = { -1, -1 };
+            if (parsed && !fields.atEnd()) {
+                parsed = fields.nextInt(lists.first, "студентов") &&
+                    fields.nextInt(lists.second, "администраторов");
+            }
+            segmentSkipped = !parsed;
+            if (!parsed) {
+                LOG_WARN("ApplicationHistory", "Ошибка разбора " << manifestFile << ", строка " << lineNumber
+                    << ": " << fields.error() << ". Сегмент пропущен");
+                return;
+            }
+            declared.push_back(lists);
+
+            segment.file = std::string(name);
+            segment.from = static_cast<std::time_t>(from);
+            segment.to = static_cast<std::time_t>(to);
+            segment.count = static_cast<size_t>(count);
+            sealedRecords += segment.count;
+            for (size_t a = 0; a < ACTION_COUNT; ++a) {
+                unloadedActionCounts[a] += segment.actions[a];
+            }
+            segments.push_back(std::move(segment));
+            });
+    }
+
+    // Списки участников проверяются по заявленным размерам. Сегменты без них
+    // (манифест старой версии или ошибка разбора) читаются один раз, и
+    // манифест переписывается
+    bool rebuilt = false;
+    auto byId = [](const std::pair<uint32_t, int>& a, const std::pair<uint32_t, int>& b) {
+        return a.first < b.first;
+    };
+    for (size_t i = 0; i < segments.size(); ++i) {
+        Segment& segment = segments[i];
+        segment.indexed = declared[i].first == static_cast<int>(segment.students.size()) &&
+            declared[i].second == static_cast<int>(segment.admins.size());
+        if (segment.indexed) {
+            // Идентификаторы словаря выдаются заново при каждом запуске
+            std::sort(segment.students.begin(), segment.students.end(), byId);
+            std::sort(segment.admins.begin(), segment.admins.end(), byId);
+            continue;
+        }
+
+        std::vector<HistoryRecord> segmentRecords;
+        if (!readSegment(segment, segmentRecords) || segmentRecords.size() != segment.count) {
+            LOG_WARN("ApplicationHistory", "Сегмент " << segment.file
+                << " недоступен, его записи будут просматриваться при каждом запросе");
+            segment.students.clear();
+            segment.admins.clear();
+            continue;
+        }
+        const HistoryRecord* first = segmentRecords.data();
+        indexSegment(segment, first, first + segmentRecords.size());
+        rebuilt = true;
+    }
+    if (rebuilt && !saveManifest()) {
+        LOG_WARN("ApplicationHistory", "Не удалось обновить манифест " << manifestFile);
+    }
+
+    firstLoadedSegment = segments.size();
+    unloadedRecords = sealedRecords;
+}
+
+void ApplicationHistory::indexSegment(Segment& segment, const HistoryRecord* first, const HistoryRecord* last) {
+    std::map<uint32_t, int> students;
+    std::map<uint32_t, int> admins;
+    segment.actions.fill(0);
+    for (const HistoryRecord* record = first; record != last; ++record) {
+        size_t action = static_cast<size_t>(record->action);
+        if (action < ACTION_COUNT) segment.actions[action]++;
+        students[record->studentId]++;
+        admins[record->adminId]++;
+    }
+    segment.students.assign(students.begin(), students.end());
+    segment.admins.assign(admins.begin(), admins.end());
+    segment.indexed = true;
+}
+
+int ApplicationHistory::countIn(const std::vector<std::pair<uint32_t, int>>& list, uint32_t id) {
+    auto it = std::lower_bound(list.begin(), list.end(), id,
+        [](const std::pair<uint32_t, int>& entry, uint32_t key) { return entry.first < key; });
+    return it != list.end() && it->first == id ? it->second : 0;
+}
+
+bool ApplicationHistory::saveManifest() const {
+    std::string data = MANIFEST_HEADER;
+    data += " " + std::to_string(segments.size()) + "\n";
+    for (const auto& segment : segments) {
+        data += segment.file;
+        data += '|';
+        data += std::to_string(static_cast<long long>(segment.from));
+        data += '|';
+        data += std::to_string(static_cast<long long>(segment.to));
+        data += '|';
+        data += std::to_string(segment.count);
+        for (int actions : segment.actions) {
+            data += '|';
+            data += std::to_string(actions);
+        }
+        if (segment.indexed) {
+            data += '|';
+            data += std::to_string(segment.students.size());
+            data += '|';
+            data += std::to_string(segment.admins.size());
+        }
+        data += '\n';
+        if (!segment.indexed) continue;
+
+        for (const auto& entry : segment.students) {
+            data += "+S|";
+            data += HistoryRecord::symbol(entry.first);
+            data += '|';
+            data += std::to_string(entry.second);
+            data += '\n';
+        }
+        for (const auto& entry : segment.admins) {
+            data += "+A|";
+            data += HistoryRecord::symbol(entry.first);
+            data += '|';
+            data += std::to_string(entry.second);
+            data += '\n';
+        }
+    }
+    return FileManager::writeData(manifestFile, data);
+}
+
+std::string ApplicationHistory::segmentPath(const std::string& name) const {
+    return (std::filesystem::path(historyFile).parent_path() / name).string();
+}
+
+bool ApplicationHistory::readSegment(const Segment& segment, std::vector<HistoryRecord>& out) const {
+    std::string path = segmentPath(segment.file);
+    long long base = 0;
+    return std::filesystem::exists(path) && (isArchiveFile(segment.file)
+        ? HistoryArchive::read(path, 0, 0, out)
+        : readSnapshot(path, out, base));
+}
+
+void ApplicationHistory::loadSegments(size_t first) {
+    if (first >= firstLoadedSegment) return;
+
+    size_t expected = records.size();
+    for (size_t i = first; i < firstLoadedSegment; ++i) expected += segments[i].count;
+
+    std::vector<HistoryRecord> loaded;
+    loaded.reserve(expected);
+    for (size_t i = first; i < firstLoadedSegment; ++i) {
+        const Segment& segment = segments[i];
+        std::string path = segmentPath(segment.file);
+        size_t before = loaded.size();
+        if (!readSegment(segment, loaded)) {
+            LOG_ERROR("ApplicationHistory", "Сегмент истории " << path << " недоступен");
+        }
+        else if (loaded.size() - before != segment.count) {
+            LOG_ERROR("ApplicationHistory", "В сегменте " << path << " " << (loaded.size() - before)
+                << " записей вместо " << segment.count);
+        }
+
+        unloadedRecords -= segment.count;
+        for (size_t a = 0; a < ACTION_COUNT; ++a) {
+            unloadedActionCounts[a] -= segment.actions[a];
+        }
+    }
+
+    // Старые записи встают перед загруженными; глобальные номера записей
+    // (unloadedRecords + позиция) при этом не меняются
+    size_t inserted = loaded.size();
+    loaded.insert(loaded.end(), records.begin(), records.end());
+    records.swap(loaded);
+    activeStart += inserted;
+    batchStart += inserted;
+    firstLoadedSegment = first;
+
+    indexPrepended(inserted);
+    invalidateSnapshot();
+}
+
+size_t ApplicationHistory::firstSegmentSince(std::time_t from) const {
+    size_t first = firstLoadedSegment;
+    while (first > 0 && (from <= 0 || segments[first - 1].to >= from)) {
+        --first;
+    }
+    return first;
+}
+
+std::shared_lock<std::shared_mutex> ApplicationHistory::lockLoadedSince(std::time_t from) const {
+    std::shared_lock<std::shared_mutex> shared(loadMutex);
+    if (firstSegmentSince(from) == firstLoadedSegment) return shared;
+
+    shared.unlock();
+    {
+        std::unique_lock<std::shared_mutex> exclusive(loadMutex);
+        // Пока блокировка не была взята, сегменты мог загрузить другой запрос
+        size_t first = firstSegmentSince(from);
+        if (first < firstLoadedSegment) {
+            // Объект истории не создаётся константным: const-запросы только
+            // дочитывают уже существующие записи с диска
+            const_cast<ApplicationHistory*>(this)->loadSegments(first);
+        }
+    }
+    shared.lock();
+    return shared;
+}
+
+// Подгружает сегменты перед expectedFirst (но не раньше from) для
+// постраничного обхода. Каждый вызов читает не меньше записей, чем уже
+// загружено, поэтому обход всей истории индексирует каждую запись O(1) раз
+// в среднем. Вызывается без блокировки; false, если загружать нечего.
+bool ApplicationHistory::loadOlderSegments(size_t expectedFirst, std::time_t from) const {
+    std::unique_lock<std::shared_mutex> exclusive(loadMutex);
+    if (firstLoadedSegment != expectedFirst) return firstLoadedSegment < expectedFirst;
+    if (expectedFirst == 0 || (from > 0 && segments[expectedFirst - 1].to < from)) return false;
+
+    size_t first = expectedFirst - 1;
+    size_t count = segments[first].count;
+    while (first > 0 && count < records.size() &&
+        (from <= 0 || segments[first - 1].to >= from)) {
+        --first;
+        count += segments[first].count;
+    }
+    const_cast<ApplicationHistory*>(this)->loadSegments(first);
+    return true;
+}
+
+size_t ApplicationHistory::getLoadedSegmentCount() const {
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    return segments.size() - firstLoadedSegment;
+}
+
+int ApplicationHistory::getTotalCount() const {
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    return static_cast<int>(unloadedRecords + records.size());
+}
+
+bool ApplicationHistory::needsRotation() const {
+    if (batchDepth > 0 || records.size() <= activeStart) return false;
+    return records.size() - activeStart > segmentLimit ||
+        monthKey(records[activeStart].timestamp) != monthKey(records.back().timestamp);
+}
+
+void ApplicationHistory::rotateSegments() {
+    // Активный сегмент режется по границам месяцев и по segmentLimit;
+    // последний кусок остаётся активным
+    size_t chunkStart = activeStart;
+    int chunkMonth = monthKey(records[chunkStart].timestamp);
+    for (size_t i = activeStart + 1; i < records.size(); ++i) {
+        int month = monthKey(records[i].timestamp);
+        if (month == chunkMonth && i - chunkStart < segmentLimit) continue;
+        if (!sealSegment(chunkStart, i)) break;
+        chunkStart = i;
+        chunkMonth = month;
+    }
+
+    if (chunkStart != activeStart) {
+        activeStart = chunkStart;
+        compact();
+        archiveSegments();
+    }
+}
+
+void ApplicationHistory::archiveSegments() {
+    // Порядок: архив, манифест с новым именем, удаление исходного сегмента.
+    // При сбое остаётся лишний файл, но не теряются записи
+    std::time_t cutoff = std::time(nullptr) - archiveAge;
+    for (auto& segment : segments) {
+        if (isArchiveFile(segment.file) || segment.to >= cutoff) continue;
+
+        std::string sourcePath = segmentPath(segment.file);
+        std::vector<HistoryRecord> segmentRecords;
+        long long base = 0;
+        if (!readSnapshot(sourcePath, segmentRecords, base) || segmentRecords.size() != segment.count) {
+            continue;
+        }
+
+        std::string sourceName = segment.file;
+        std::string archiveName = std::filesystem::path(sourceName).replace_extension(".arc").string();
+        const HistoryRecord* first = segmentRecords.data();
+        if (!HistoryArchive::write(segmentPath(archiveName), first, first + segmentRecords.size())) {
+            continue;
+        }
+
+        segment.file = archiveName;
+        if (!saveManifest()) {
+            segment.file = sourceName;
+            continue;
+        }
+        FileManager::removeFile(sourcePath);
+    }
+}
+
+HistoryView ApplicationHistory::readUnloadedRange(std::time_t from, std::time_t to) const {
+    std::vector<HistoryRecord> found;
+    for (size_t i = 0; i < firstLoadedSegment; ++i) {
+        const Segment& segment = segments[i];
+        if (segment.to < from || segment.from > to) continue;
+
+        std::string path = segmentPath(segment.file);
+        size_t start = found.size();
+        long long base = 0;
+        if (isArchiveFile(segment.file)) {
+            HistoryArchive::read(path, from, to, found);
+        }
+        else {
+            readSnapshot(path, found, base);
+        }
+
+        // Файлы и блоки читаются целиком, записи по краям периода отбрасываются
+        found.erase(std::remove_if(found.begin() + start, found.end(),
+            [from, to](const HistoryRecord& record) {
+                return record.timestamp < from || record.timestamp > to;
+            }), found.end());
+    }
+
+    size_t count = found.size();
+    return HistoryView(HistorySnapshot::fromRecords(found), 0, count);
+}
+
+bool ApplicationHistory::sealSegment(size_t begin, size_t end) {
+    // Порядок записи: файл сегмента, манифест, затем активный снимок (compact).
+    // Если сбой случится до манифеста, сегмент не считается закрытым; после -
+    // повторно попавшие в активный снимок записи отбросит loadFromFile по #BASE
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%06zu.seg", segments.size() + 1);
+
+    Segment segment;
+    segment.file = std::filesystem::path(historyFile).stem().string() + suffix;
+    segment.from = records[begin].timestamp;
+    segment.to = records[end - 1].timestamp;
+    segment.count = end - begin;
+    const HistoryRecord* first = records.data() + begin;
+    indexSegment(segment, first, first + segment.count);
+
+    if (!FileManager::writeData(segmentPath(segment.file),
+        serializeRecords(first, first + segment.count, sealedRecords))) {
+        return false;
+    }
+
+    segments.push_back(segment);
+    sealedRecords += segment.count;
+    if (!saveManifest()) {
+        segments.pop_back();
+        sealedRecords -= segment.count;
+        return false;
+    }
+    return true;
+}
+
+void ApplicationHistory::indexRecord(size_t pos, bool counted) {
+    const HistoryRecord& record = records[pos];
+    if (record.studentId >= recordsByStudent.size()) {
+        recordsByStudent.resize(static_cast<size_t>(record.studentId) + 1);
+    }
+    recordsByStudent[record.studentId].push_back(pos);
+    if (!counted) {
+        studentCounts.increment(record.studentId);
+        if (record.adminId != 0) {
+            adminCounts.increment(record.adminId);
+        }
+    }
+
+    size_t action = static_cast<size_t>(record.action);
+    if (action < ACTION_COUNT) actionCounts[action]++;
+    rollup.add(record.action, record.scholarshipTypeId, record.adminId, record.timestamp);
+
+    addTermPosition(searchTermForSymbol(record.studentId), pos);
+    addTermPosition(searchTermForSymbol(record.scholarshipTypeId), pos);
+    addTermPosition(searchTermForSymbol(record.adminId), pos);
+    addTermPosition(searchTermForAppId(record.applicationId), pos);
+}
+
+namespace {
+    uint32_t trigramKey(const std::string& s, size_t i) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(s[i])) << 16) |
+            (static_cast<uint32_t>(static_cast<unsigned char>(s[i + 1])) << 8) |
+            static_cast<uint32_t>(static_cast<unsigned char>(s[i + 2]));
+    }
+}
+
+uint32_t ApplicationHistory::internSearchTerm(const std::string& value) {
+    if (value.empty()) return StringDictionary::NOT_FOUND;
 
-    for (const auto& line : lines) {
-        if (line.empty()) continue;
+    std::string term = Utils::toLowerCP1251(value);
+    uint32_t id = searchTerms.find(term);
+    if (id == StringDictionary::NOT_FOUND) {
+        // Новый терм: регистрируем его триграммы один раз
+        id = searchTerms.intern(term);
+        recordsByTerm.resize(id + 1);
+        for (size_t i = 0; i + 3 <= term.size(); ++i) {
+            auto& terms = termsByTrigram[trigramKey(term, i)];
+            if (terms.empty() || terms.back() != id) terms.push_back(id);
+        }
+    }
+    return id;
+}
 
-        std::stringstream ss(line);
-        std::string part;
-        std::vector<std::string> parts;
+uint32_t ApplicationHistory::searchTermForSymbol(uint32_t symbol) {
+    if (symbol >= termBySymbol.size()) {
+        termBySymbol.resize(static_cast<size_t>(symbol) + 1, UINT32_MAX - 1);
+    }
+    // UINT32_MAX - 1 - терм ещё не вычислялся
+    if (termBySymbol[symbol] == UINT32_MAX - 1) {
+        termBySymbol[symbol] = internSearchTerm(HistoryRecord::symbol(symbol));
+    }
+    return termBySymbol[symbol];
+}
+
+uint32_t ApplicationHistory::searchTermForAppId(int appId) {
+    // ID выдаются подряд, поэтому хватает плотной таблицы
+    const int maxCachedId = 1 << 24;
+    if (appId <= 0 || appId >= maxCachedId) {
+        return internSearchTerm(std::to_string(appId));
+    }
+    if (static_cast<size_t>(appId) >= termByAppId.size()) {
+        termByAppId.resize(static_cast<size_t>(appId) + 1, UINT32_MAX - 1);
+    }
+    if (termByAppId[appId] == UINT32_MAX - 1) {
+        termByAppId[appId] = internSearchTerm(std::to_string(appId));
+    }
+    return termByAppId[appId];
+}
 
-        while (std::getline(ss, part, '|')) {
-            parts.push_back(part);
+void ApplicationHistory::addTermPosition(uint32_t term, size_t pos) {
+    if (term == StringDictionary::NOT_FOUND) return;
+
+    // Одно значение может встретиться в записи дважды (студент и администратор)
+    auto& positions = recordsByTerm[term];
+    if (positions.empty() || positions.back() != pos) positions.push_back(pos);
+}
+
+const std::vector<size_t>* ApplicationHistory::studentPositions(const std::string& username) const {
+    uint32_t sym = HistoryRecord::findSymbol(username);
+    if (sym == StringDictionary::NOT_FOUND || sym >= recordsByStudent.size()) return nullptr;
+    return &recordsByStudent[sym];
+}
+
+void ApplicationHistory::rebuildIndex() {
+    recordsByStudent.clear();
+    searchTerms.clear();
+    recordsByTerm.clear();
+    termsByTrigram.clear();
+    termBySymbol.clear();
+    termByAppId.clear();
+    actionCounts.fill(0);
+    studentCounts.clear();
+    adminCounts.clear();
+    rollup.clear();
+    // Неподгруженные сегменты учитываются по спискам участников из манифеста
+    for (size_t i = 0; i < firstLoadedSegment; ++i) {
+        for (const auto& entry : segments[i].students) {
+            studentCounts.add(entry.first, entry.second);
         }
+        for (const auto& entry : segments[i].admins) {
+            if (entry.first != 0) adminCounts.add(entry.first, entry.second);
+        }
+    }
+    for (size_t i = 0; i < records.size(); ++i) {
+        indexRecord(i);
+    }
+}
 
-        if (parts.size() < 7) continue;  
+// Дополняет индексы после вставки inserted записей в начало records:
+// индексируются только новые записи, позиции прежних сдвигаются
+void ApplicationHistory::indexPrepended(size_t inserted) {
+    if (inserted == 0) return;
 
-        try {
-            HistoryRecord record;
-            record.applicationId = std::stoi(parts[0]);
-            record.studentUsername = parts[1];
-            record.scholarshipType = parts[2];
-            record.action = static_cast<HistoryAction>(std::stoi(parts[3]));
-            record.adminUsername = parts[4];
-            record.comment = parts[5];
-            record.timestamp = std::stoll(parts[6]);
+    std::vector<std::vector<size_t>> shiftedByStudent;
+    std::vector<std::vector<size_t>> shiftedByTerm;
+    shiftedByStudent.swap(recordsByStudent);
+    shiftedByTerm.swap(recordsByTerm);
+    recordsByTerm.resize(shiftedByTerm.size());
 
-            records.push_back(record);
+    // Счётчики и агрегаты не зависят от порядка записей, а списки позиций
+    // новых записей собираются с нуля и идут перед сдвинутыми. Студенты и
+    // администраторы подгруженных сегментов уже учтены по манифесту
+    for (size_t i = 0; i < inserted; ++i) {
+        indexRecord(i, true);
+    }
+
+    auto append = [inserted](std::vector<std::vector<size_t>>& lists,
+        const std::vector<std::vector<size_t>>& shifted) {
+        if (lists.size() < shifted.size()) lists.resize(shifted.size());
+        for (size_t key = 0; key < shifted.size(); ++key) {
+            auto& positions = lists[key];
+            positions.reserve(positions.size() + shifted[key].size());
+            for (size_t pos : shifted[key]) positions.push_back(pos + inserted);
         }
-        catch (...) {
-            //   
+    };
+    append(recordsByStudent, shiftedByStudent);
+    append(recordsByTerm, shiftedByTerm);
+}
+
+std::string ApplicationHistory::serializeRecords(const HistoryRecord* first,
+    const HistoryRecord* last, size_t base) {
+    // Словарь снимка содержит только строки, встречающиеся в записях,
+    // и нумерует их заново с 1 (0 - пустая строка)
+    std::vector<uint32_t> localIds(HistoryRecord::symbolCount(), UINT32_MAX);
+    std::vector<uint32_t> dictionary;
+    localIds[0] = 0;
+    auto localId = [&](uint32_t id) {
+        if (localIds[id] == UINT32_MAX) {
+            dictionary.push_back(id);
+            localIds[id] = static_cast<uint32_t>(dictionary.size());
+        }
+        return localIds[id];
+    };
+
+    std::string body;
+    body.reserve(static_cast<size_t>(last - first) * 40);
+    for (const HistoryRecord* it = first; it != last; ++it) {
+        const HistoryRecord& record = *it;
+        body += std::to_string(record.applicationId);
+        body += '|';
+        body += std::to_string(localId(record.studentId));
+        body += '|';
+        body += std::to_string(localId(record.scholarshipTypeId));
+        body += '|';
+        body += std::to_string(static_cast<int>(record.action));
+        body += '|';
+        body += std::to_string(localId(record.adminId));
+        body += '|';
+        body += std::to_string(localId(record.commentId));
+        body += '|';
+        body += std::to_string(static_cast<long long>(record.timestamp));
+        body += '\n';
+    }
+
+    std::string data = SNAPSHOT_HEADER;
+    data += "\n#BASE " + std::to_string(base);
+    data += "\n#DICT " + std::to_string(dictionary.size()) + "\n";
+    for (uint32_t id : dictionary) {
+        data += HistoryRecord::symbol(id);
+        data += '\n';
+    }
+    data += "#RECORDS " + std::to_string(last - first) + "\n";
+    data += body;
+    return data;
+}
+
+bool ApplicationHistory::saveToFile() const {
+    // Снимок содержит только активный сегмент
+    const HistoryRecord* first = records.data() + activeStart;
+    return FileManager::writeData(historyFile,
+        serializeRecords(first, records.data() + records.size(), sealedRecords));
+}
+
+void ApplicationHistory::appendToJournal(const HistoryRecord& record) {
+    std::string line = std::to_string(records.size() - 1 - activeStart) + "|" + formatRecord(record);
+    if (batchDepth > 0) {
+        pendingJournal.push_back(line);
+        return;
+    }
+
+    bool sync = false;
+    switch (syncPolicy) {
+    case SyncPolicy::Always:
+        sync = true;
+        break;
+    case SyncPolicy::Periodic:
+        if (++unsyncedCount >= syncInterval) {
+            sync = true;
+            unsyncedCount = 0;
         }
+        break;
+    case SyncPolicy::None:
+        break;
+    }
+
+    journalCount++;
+    if (!writer) {
+        FileManager::appendLines(journalFile, { line }, sync);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(journalBufferMutex);
+        journalBuffer.push_back(std::move(line));
+        journalBufferSync = journalBufferSync || sync;
     }
+    // Задачи с одним ключом сливаются: пока запись не началась, новые строки
+    // просто дописываются в буфер
+    writer->submit(journalFile, [this]() { return drainJournal(); });
 }
 
-void ApplicationHistory::saveToFile() const {
+bool ApplicationHistory::drainJournal() {
     std::vector<std::string> lines;
+    bool sync;
+    {
+        std::lock_guard<std::mutex> lock(journalBufferMutex);
+        lines.swap(journalBuffer);
+        sync = journalBufferSync;
+        journalBufferSync = false;
+    }
+    if (lines.empty()) return !journalWriteFailed;
+
+    bool written = FileManager::appendLines(journalFile, lines, sync);
+    std::lock_guard<std::mutex> lock(journalBufferMutex);
+    if (!written) {
+        // Строки возвращаются в начало буфера перед добавленными за время
+        // записи и будут записаны следующей задачей
+        journalBuffer.insert(journalBuffer.begin(),
+            std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+        journalBufferSync = journalBufferSync || sync;
+    }
+    journalWriteFailed = !written;
+    return written;
+}
 
-    for (const auto& record : records) {
-        std::stringstream ss;
-        ss << record.applicationId << "|"
-            << record.studentUsername << "|"
-            << record.scholarshipType << "|"
-            << static_cast<int>(record.action) << "|"
-            << record.adminUsername << "|"
-            << record.comment << "|"
-            << record.timestamp;
-        lines.push_back(ss.str());
+bool ApplicationHistory::flushJournal() {
+    if (!writer) return true;
+    bool pending;
+    {
+        std::lock_guard<std::mutex> lock(journalBufferMutex);
+        pending = !journalBuffer.empty();
+    }
+    // Строки, оставшиеся после неудачной записи, пишутся повторно
+    if (pending) {
+        writer->submit(journalFile, [this]() { return drainJournal(); });
     }
+    return flushWriter();
+}
+
+void ApplicationHistory::discardJournalBuffer() {
+    std::lock_guard<std::mutex> lock(journalBufferMutex);
+    journalBuffer.clear();
+    journalBufferSync = false;
+    journalWriteFailed = false;
+}
 
-    FileManager::writeLines(historyFile, lines);
+bool ApplicationHistory::flushWriter() {
+    // Перед синхронной работой с файлами истории фоновые записи завершаются.
+    // Результат берётся из буфера, а не из writer: неудавшиеся строки этой
+    // истории остаются в буфере до успешной записи, а ошибки чужих задач
+    // writer к журналу отношения не имеют
+    if (!writer) return true;
+    writer->wait();
+    std::lock_guard<std::mutex> lock(journalBufferMutex);
+    return journalBuffer.empty() && !journalWriteFailed;
+}
+
+void ApplicationHistory::setSyncPolicy(SyncPolicy policy, int interval) {
+    syncPolicy = policy;
+    syncInterval = interval > 0 ? interval : 1;
+    unsyncedCount = 0;
+}
+
+void ApplicationHistory::compact() {
+    bool journalWritten = flushWriter();
+    // Сначала снимок, затем удаление журнала: при сбое между шагами
+    // повторное чтение журнала отбросит уже вошедшие в снимок записи.
+    // Если снимок не записан, незаписанные строки журнала ждут повтора
+    if (!saveToFile()) return;
+    // Незаписанные строки журнала уже вошли в снимок
+    if (!journalWritten) {
+        LOG_WARN("ApplicationHistory", "Строки, не записанные в журнал, сохранены в снимке " << historyFile);
+    }
+    discardJournalBuffer();
+    FileManager::removeFile(journalFile);
+    journalCount = 0;
+    unsyncedCount = 0;
+}
+
+void ApplicationHistory::beginBatch() {
+    if (batchDepth++ == 0) {
+        batchStart = records.size();
+        pendingJournal.clear();
+    }
+}
+
+bool ApplicationHistory::commitBatch() {
+    if (batchDepth == 0) return false;
+    if (--batchDepth > 0) return true;
+
+    if (!pendingJournal.empty()) {
+        // Пакет пишется синхронно, чтобы при ошибке его можно было откатить.
+        // Если более ранние строки не записаны, пакет встал бы в журнал
+        // перед ними - он откатывается
+        if (!flushWriter()) {
+            batchDepth = 1;
+            rollbackBatch();
+            return false;
+        }
+        bool sync = syncPolicy != SyncPolicy::None;
+        if (!FileManager::appendLines(journalFile, pendingJournal, sync)) {
+            batchDepth = 1;
+            rollbackBatch();
+            return false;
+        }
+        journalCount += static_cast<int>(pendingJournal.size());
+        unsyncedCount = 0;
+        pendingJournal.clear();
+    }
+
+    if (needsRotation()) {
+        rotateSegments();
+    }
+    else if (journalCount >= compactionThreshold) {
+        compact();
+    }
+    return true;
+}
+
+void ApplicationHistory::rollbackBatch() {
+    if (batchDepth == 0) return;
+    batchDepth = 0;
+    pendingJournal.clear();
+    if (records.size() > batchStart) {
+        records.resize(batchStart);
+        rebuildIndex();
+        invalidateSnapshot();
+    }
 }
 
 void ApplicationHistory::addRecord(int appId, const std::string& student,
@@ -68,124 +1055,282 @@ void ApplicationHistory::addRecord(int appId, const std::string& student,
     const std::string& admin, const std::string& comment) {
     HistoryRecord record;
     record.applicationId = appId;
-    record.studentUsername = student;
-    record.scholarshipType = scholarship;
+    record.setStudentUsername(student);
+    record.setScholarshipType(scholarship);
     record.action = action;
-    record.adminUsername = admin;
-    record.comment = comment;
+    record.setAdminUsername(admin);
+    record.setComment(comment);
+    // Записи упорядочены по времени: при переводе часов назад
+    // новая запись получает время предыдущей
     record.timestamp = std::time(nullptr);
+    std::time_t latest = !records.empty() ? records.back().timestamp
+        : !segments.empty() ? segments.back().to : 0;
+    if (record.timestamp < latest) {
+        record.timestamp = latest;
+    }
 
     records.push_back(record);
-    saveToFile();
+    indexRecord(records.size() - 1);
+    appendToSnapshot(record);
+    appendToJournal(record);
+
+    if (batchDepth > 0) return;
+    if (needsRotation()) {
+        rotateSegments();
+    }
+    else if (journalCount >= compactionThreshold) {
+        compact();
+    }
 }
 
-std::vector<HistoryRecord> ApplicationHistory::getAllRecords() const {
-    auto sorted = records;
-    std::sort(sorted.begin(), sorted.end(),
-        [](const HistoryRecord& a, const HistoryRecord& b) {
-            return a.timestamp > b.timestamp;
-        });
-    return sorted;
+namespace {
+    std::shared_ptr<const HistorySnapshot::ChunkTable> buildChunks(
+        const std::vector<HistoryRecord>& records) {
+        auto table = std::make_shared<HistorySnapshot::ChunkTable>();
+        table->reserve((records.size() + HistorySnapshot::CHUNK_SIZE - 1) / HistorySnapshot::CHUNK_SIZE);
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (i % HistorySnapshot::CHUNK_SIZE == 0) table->push_back(HistorySnapshot::makeChunk());
+            table->back()[i % HistorySnapshot::CHUNK_SIZE] = records[i];
+        }
+        return table;
+    }
+}
+
+HistorySnapshot HistorySnapshot::fromRecords(const std::vector<HistoryRecord>& records) {
+    return HistorySnapshot(buildChunks(records), records.size());
 }
 
-std::vector<HistoryRecord> ApplicationHistory::getRecordsByStudent(
+void ApplicationHistory::invalidateSnapshot() {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    snapshotChunks.reset();
+}
+
+void ApplicationHistory::appendToSnapshot(const HistoryRecord& record) {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (!snapshotChunks) return;
+
+    // Позиции до pos видны в уже выданных снимках и не меняются
+    size_t pos = records.size() - 1;
+    if (pos % HistorySnapshot::CHUNK_SIZE == 0) {
+        auto table = std::make_shared<HistorySnapshot::ChunkTable>(*snapshotChunks);
+        table->push_back(HistorySnapshot::makeChunk());
+        snapshotChunks = std::move(table);
+    }
+    (*snapshotChunks)[pos / HistorySnapshot::CHUNK_SIZE][pos % HistorySnapshot::CHUNK_SIZE] = record;
+}
+
+HistorySnapshot ApplicationHistory::getSnapshot() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (!snapshotChunks) {
+        snapshotChunks = buildChunks(records);
+    }
+    return HistorySnapshot(snapshotChunks, records.size());
+}
+
+HistoryView ApplicationHistory::getAllRecords() const {
+    auto lock = lockAllLoaded();
+    HistorySnapshot current = getSnapshot();
+    size_t count = current.size();
+    return HistoryView(std::move(current), 0, count);
+}
+
+// Неподгруженные сегменты читаются с диска, но не загружаются: в память
+// попадают только подходящие записи, а загруженный хвост не растёт
+template<typename SegmentFilter, typename RecordFilter>
+HistoryView ApplicationHistory::withUnloaded(SegmentFilter wanted, RecordFilter match,
+    HistorySnapshot current, std::vector<size_t> positions) const {
+    std::vector<HistoryRecord> found;
+    for (size_t i = 0; i < firstLoadedSegment; ++i) {
+        const Segment& segment = segments[i];
+        if (!wanted(segment)) continue;
+
+        size_t start = found.size();
+        readSegment(segment, found);
+        found.erase(std::remove_if(found.begin() + start, found.end(),
+            [&match](const HistoryRecord& record) { return !match(record); }), found.end());
+    }
+    if (found.empty()) return HistoryView(std::move(current), std::move(positions));
+
+    // Записи сегментов старше загруженных, поэтому порядок по времени сохраняется
+    found.reserve(found.size() + positions.size());
+    for (size_t pos : positions) {
+        found.push_back(current[pos]);
+    }
+    size_t count = found.size();
+    return HistoryView(HistorySnapshot::fromRecords(found), 0, count);
+}
+
+HistoryView ApplicationHistory::getRecordsByStudent(
     const std::string& username) const {
-    std::vector<HistoryRecord> result;
-    for (const auto& record : records) {
-        if (record.studentUsername == username) {
-            result.push_back(record);
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    HistorySnapshot current = getSnapshot();
+    uint32_t studentId = HistoryRecord::findSymbol(username);
+    if (studentId == StringDictionary::NOT_FOUND) return HistoryView(std::move(current), 0, 0);
+
+    // Позиции в индексе идут по возрастанию, как и записи снимка
+    std::vector<size_t> positions;
+    if (studentId < recordsByStudent.size()) {
+        const std::vector<size_t>& postings = recordsByStudent[studentId];
+        positions.reserve(postings.size());
+        for (size_t pos : postings) {
+            if (pos < current.size()) positions.push_back(pos);
         }
     }
-    std::sort(result.begin(), result.end(),
-        [](const HistoryRecord& a, const HistoryRecord& b) {
-            return a.timestamp > b.timestamp;
-        });
-    return result;
+    return withUnloaded(
+        [studentId](const Segment& segment) {
+            return !segment.indexed || countIn(segment.students, studentId) > 0;
+        },
+        [studentId](const HistoryRecord& record) { return record.studentId == studentId; },
+        std::move(current), std::move(positions));
 }
 
-std::vector<HistoryRecord> ApplicationHistory::getRecordsByAction(
+HistoryView ApplicationHistory::getRecordsByAction(
     HistoryAction action) const {
-    std::vector<HistoryRecord> result;
-    for (const auto& record : records) {
-        if (record.action == action) {
-            result.push_back(record);
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    HistorySnapshot current = getSnapshot();
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < current.size(); ++i) {
+        if (current[i].action == action) {
+            positions.push_back(i);
         }
     }
-    std::sort(result.begin(), result.end(),
-        [](const HistoryRecord& a, const HistoryRecord& b) {
-            return a.timestamp > b.timestamp;
-        });
-    return result;
+    size_t index = static_cast<size_t>(action);
+    return withUnloaded(
+        [index](const Segment& segment) { return index < ACTION_COUNT && segment.actions[index] > 0; },
+        [action](const HistoryRecord& record) { return record.action == action; },
+        std::move(current), std::move(positions));
 }
 
-std::vector<HistoryRecord> ApplicationHistory::getRecordsByAdmin(
+HistoryView ApplicationHistory::getRecordsByAdmin(
     const std::string& admin) const {
-    std::vector<HistoryRecord> result;
-    for (const auto& record : records) {
-        if (record.adminUsername == admin) {
-            result.push_back(record);
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    HistorySnapshot current = getSnapshot();
+    std::vector<size_t> positions;
+    uint32_t adminId = HistoryRecord::findSymbol(admin);
+    if (adminId == StringDictionary::NOT_FOUND) return HistoryView(std::move(current), 0, 0);
+
+    for (size_t i = 0; i < current.size(); ++i) {
+        if (current[i].adminId == adminId) {
+            positions.push_back(i);
         }
     }
-    std::sort(result.begin(), result.end(),
-        [](const HistoryRecord& a, const HistoryRecord& b) {
-            return a.timestamp > b.timestamp;
-        });
-    return result;
+    return withUnloaded(
+        [adminId](const Segment& segment) {
+            return !segment.indexed || countIn(segment.admins, adminId) > 0;
+        },
+        [adminId](const HistoryRecord& record) { return record.adminId == adminId; },
+        std::move(current), std::move(positions));
 }
 
-std::vector<HistoryRecord> ApplicationHistory::searchRecords(
+HistoryView ApplicationHistory::searchRecords(
     const std::string& keyword) const {
-    std::vector<HistoryRecord> result;
-    std::string lowerKeyword = keyword;
-    std::transform(lowerKeyword.begin(), lowerKeyword.end(),
-        lowerKeyword.begin(), ::tolower);
-
-    for (const auto& record : records) {
-        std::string studentLower = record.studentUsername;
-        std::transform(studentLower.begin(), studentLower.end(),
-            studentLower.begin(), ::tolower);
-
-        std::string scholarshipLower = record.scholarshipType;
-        std::transform(scholarshipLower.begin(), scholarshipLower.end(),
-            scholarshipLower.begin(), ::tolower);
+    auto lock = lockAllLoaded();
+    HistorySnapshot current = getSnapshot();
+    std::string needle = Utils::toLowerCP1251(keyword);
+    if (needle.empty()) {
+        size_t count = current.size();
+        return HistoryView(std::move(current), 0, count);
+    }
 
-        std::string adminLower = record.adminUsername;
-        std::transform(adminLower.begin(), adminLower.end(),
-            adminLower.begin(), ::tolower);
+    // Кандидаты - термы из самого короткого списка триграмм образца;
+    // для образцов короче трёх символов перебираются все термы
+    std::vector<uint32_t> allTerms;
+    const std::vector<uint32_t>* candidates = nullptr;
+    if (needle.size() >= 3) {
+        for (size_t i = 0; i + 3 <= needle.size(); ++i) {
+            auto it = termsByTrigram.find(trigramKey(needle, i));
+            if (it == termsByTrigram.end()) return HistoryView(std::move(current), 0, 0);
+            if (!candidates || it->second.size() < candidates->size()) {
+                candidates = &it->second;
+            }
+        }
+    }
+    else {
+        allTerms.resize(searchTerms.size());
+        for (uint32_t id = 0; id < allTerms.size(); ++id) allTerms[id] = id;
+        candidates = &allTerms;
+    }
 
-        if (studentLower.find(lowerKeyword) != std::string::npos ||
-            scholarshipLower.find(lowerKeyword) != std::string::npos ||
-            adminLower.find(lowerKeyword) != std::string::npos ||
-            std::to_string(record.applicationId).find(keyword) != std::string::npos) {
-            result.push_back(record);
+    std::vector<size_t> positions;
+    size_t matchedTerms = 0;
+    for (uint32_t id : *candidates) {
+        if (searchTerms.str(id).find(needle) == std::string::npos) continue;
+        for (size_t pos : recordsByTerm[id]) {
+            if (pos < current.size()) positions.push_back(pos);
         }
+        matchedTerms++;
     }
 
-    std::sort(result.begin(), result.end(),
-        [](const HistoryRecord& a, const HistoryRecord& b) {
-            return a.timestamp > b.timestamp;
-        });
-    return result;
+    // Запись могла подойти по нескольким полям
+    if (matchedTerms > 1) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+    return HistoryView(std::move(current), std::move(positions));
 }
 
 int ApplicationHistory::getActionCount(HistoryAction action) const {
-    int count = 0;
-    for (const auto& record : records) {
-        if (record.action == action) {
-            count++;
-        }
+    size_t index = static_cast<size_t>(action);
+    // Счётчики закрытых сегментов берутся из манифеста без их загрузки
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    return index < ACTION_COUNT ? actionCounts[index] + unloadedActionCounts[index] : 0;
+}
+
+int ApplicationHistory::getStudentRecordCount(const std::string& username) const {
+    // Счётчики ведутся по всей истории, сегменты не подгружаются
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    uint32_t sym = HistoryRecord::findSymbol(username);
+    return sym == StringDictionary::NOT_FOUND ? 0 : studentCounts.count(sym);
+}
+
+int ApplicationHistory::getAdminRecordCount(const std::string& admin) const {
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    uint32_t sym = HistoryRecord::findSymbol(admin);
+    return sym == StringDictionary::NOT_FOUND || sym == 0 ? 0 : adminCounts.count(sym);
+}
+
+std::vector<std::pair<std::string, int>> ApplicationHistory::topOf(
+    const RankedCounter& counter, size_t k) {
+    std::vector<std::pair<std::string, int>> result;
+    for (const auto& entry : counter.top(k)) {
+        result.emplace_back(HistoryRecord::symbol(entry.first), entry.second);
     }
-    return count;
+    return result;
+}
+
+std::vector<std::pair<std::string, int>> ApplicationHistory::getTopStudents(size_t k) const {
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    return topOf(studentCounts, k);
+}
+
+std::vector<std::pair<std::string, int>> ApplicationHistory::getTopAdmins(size_t k) const {
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    return topOf(adminCounts, k);
+}
+
+std::vector<RollupRow> ApplicationHistory::queryRollup(RollupGranularity granularity,
+    std::time_t from, std::time_t to, const RollupFilter& filter, RollupGroup group) const {
+    // Корзина, в которую попадает from, начинается раньше него и должна
+    // быть учтена целиком
+    std::time_t since = from > 0
+        ? HistoryRollup::bucketStart(granularity, HistoryRollup::bucketOf(granularity, from))
+        : 0;
+    auto lock = lockLoadedSince(since);
+    return rollup.query(granularity, from, to, filter, group);
 }
 
 std::string HistoryRecord::actionToString() const {
+    return historyActionToString(action);
+}
+
+std::string historyActionToString(HistoryAction action) {
     switch (action) {
-    case HistoryAction::CREATED: return "";
-    case HistoryAction::APPROVED: return "";
-    case HistoryAction::REJECTED: return "";
-    case HistoryAction::DELETED: return "";
-    case HistoryAction::MODIFIED: return "";
-    default: return "";
+    case HistoryAction::CREATED: return "СОЗДАНА";
+    case HistoryAction::APPROVED: return "ОДОБРЕНА";
+    case HistoryAction::REJECTED: return "ОТКЛОНЕНА";
+    case HistoryAction::DELETED: return "УДАЛЕНА";
+    case HistoryAction::MODIFIED: return "ИЗМЕНЕНА";
+    default: return "НЕИЗВЕСТНО";
     }
 }
 
@@ -197,47 +1342,187 @@ std::string HistoryRecord::toString() const {
     strftime(timeStr, sizeof(timeStr), "%d.%m.%Y %H:%M:%S", &timeinfo);
 
     ss << "ID: " << applicationId
-        << " | : " << studentUsername
-        << " | : " << scholarshipType
-        << " | : " << actionToString()
-        << " | : " << (adminUsername.empty() ? "" : adminUsername)
-        << " | : " << timeStr;
+        << " | Студент: " << getStudentUsername()
+        << " | Стипендия: " << getScholarshipType()
+        << " | Действие: " << actionToString()
+        << " | Администратор: " << (adminId == 0 ? "система" : getAdminUsername())
+        << " | Время: " << timeStr;
 
-    if (!comment.empty()) {
-        ss << " | : " << comment;
+    if (commentId != 0) {
+        ss << " | Комментарий: " << getComment();
     }
 
     return ss.str();
 }
 
 void ApplicationHistory::clearHistory() {
+    // Незаписанные строки журнала удаляются вместе с историей
+    if (writer) writer->wait();
+    // Сначала манифест: без него файлы сегментов уже не часть истории
+    FileManager::removeFile(manifestFile);
+    for (const auto& segment : segments) {
+        FileManager::removeFile(segmentPath(segment.file));
+    }
+    segments.clear();
+    firstLoadedSegment = 0;
+    unloadedRecords = 0;
+    sealedRecords = 0;
+    unloadedActionCounts.fill(0);
+    activeStart = 0;
+
     records.clear();
+    rebuildIndex();
+    invalidateSnapshot();
+    // Журнал удаляется первым, чтобы его записи не вернулись в пустой снимок
+    discardJournalBuffer();
+    FileManager::removeFile(journalFile);
+    journalCount = 0;
+    unsyncedCount = 0;
     saveToFile();
 }
-std::vector<HistoryRecord> ApplicationHistory::getRecordsSince(std::time_t since) const {
-    std::vector<HistoryRecord> result;
-    for (const auto& record : records) {
-        if (record.timestamp >= since) {
-            result.push_back(record);
+HistoryPage HistoryQuery::fetch() const {
+    return history.fetchPage(filter, cursor, pageSize, forward);
+}
+
+HistoryPage ApplicationHistory::fetchPage(const HistoryFilter& filter,
+    HistoryCursor cursor, size_t limit, bool forward) const {
+    HistoryPage page;
+
+    // От старых к новым: обход начинается с самых старых записей периода,
+    // поэтому они подгружаются сразу
+    if (forward) {
+        auto lock = lockLoadedSince(filter.from);
+        size_t low = cursor.atStart() ? 0 : cursor.position + 1;
+        collectPage(filter, low, SIZE_MAX, true, limit, page);
+        return page;
+    }
+
+    // Если загруженных записей не хватило на страницу, подгружаются более
+    // старые сегменты и просмотр продолжается с конца последнего из них
+    size_t high = cursor.position;
+    std::shared_lock<std::shared_mutex> lock(loadMutex);
+    while (!collectPage(filter, 0, high, false, limit, page)) {
+        size_t loadedFirst = firstLoadedSegment;
+        high = std::min(high, unloadedRecords);
+        lock.unlock();
+        bool loaded = loadOlderSegments(loadedFirst, filter.from);
+        lock.lock();
+        if (!loaded) break;
+    }
+    return page;
+}
+
+// Дополняет страницу записями с глобальными номерами из [low, high) (номер
+// записи - unloadedRecords + позиция в records), от новых к старым или при
+// forward от старых к новым. true, если страница заполнена и найдена
+// следующая подходящая запись.
+bool ApplicationHistory::collectPage(const HistoryFilter& filter, size_t low, size_t high,
+    bool forward, size_t limit, HistoryPage& page) const {
+    size_t base = unloadedRecords;
+    auto byTime = [](const HistoryRecord& record, std::time_t t) { return record.timestamp < t; };
+
+    // Границы по времени и курсору в позициях records
+    low = low > base ? std::min(low - base, records.size()) : 0;
+    high = high > base ? std::min(high - base, records.size()) : 0;
+    if (filter.from > 0) {
+        low = std::max(low, static_cast<size_t>(std::lower_bound(records.begin(), records.end(),
+            filter.from, byTime) - records.begin()));
+    }
+    if (filter.to > 0) {
+        size_t bound = static_cast<size_t>(std::upper_bound(records.begin(), records.end(),
+            filter.to, [](std::time_t t, const HistoryRecord& record) {
+                return t < record.timestamp;
+            }) - records.begin());
+        high = std::min(high, bound);
+    }
+    if (low >= high) return false;
+
+    uint32_t adminId = 0;
+    if (!filter.admin.empty()) {
+        adminId = HistoryRecord::findSymbol(filter.admin);
+        if (adminId == StringDictionary::NOT_FOUND) return false;
+    }
+
+    // true - страница уже заполнена, а запись pos подходит под фильтр
+    auto take = [&](size_t pos) {
+        const HistoryRecord& record = records[pos];
+        if (filter.byAction && record.action != filter.action) return false;
+        if (!filter.admin.empty() && record.adminId != adminId) return false;
+        if (page.records.size() == limit) {
+            page.hasMore = true;
+            return true;
+        }
+        page.records.push_back(record);
+        page.next.position = base + pos;
+        return false;
+    };
+
+    // Кандидаты: все позиции диапазона или позиции записей студента
+    if (!filter.student.empty()) {
+        const std::vector<size_t>* postings = studentPositions(filter.student);
+        if (!postings) return false;
+
+        auto first = std::lower_bound(postings->begin(), postings->end(), low);
+        auto last = std::lower_bound(first, postings->end(), high);
+        if (forward) {
+            for (auto it = first; it != last; ++it) {
+                if (take(*it)) return true;
+            }
+        }
+        else {
+            for (auto it = last; it != first; ) {
+                if (take(*--it)) return true;
+            }
         }
     }
-    std::sort(result.begin(), result.end(),
-        [](const HistoryRecord& a, const HistoryRecord& b) {
-            return a.timestamp > b.timestamp;
-        });
-    return result;
+    else if (forward) {
+        for (size_t pos = low; pos < high; ++pos) {
+            if (take(pos)) return true;
+        }
+    }
+    else {
+        for (size_t pos = high; pos > low; ) {
+            if (take(--pos)) return true;
+        }
+    }
+    return false;
 }
 
-std::vector<HistoryRecord> ApplicationHistory::getRecordsBetween(std::time_t from, std::time_t to) const {
-    std::vector<HistoryRecord> result;
-    for (const auto& record : records) {
-        if (record.timestamp >= from && record.timestamp <= to) {
-            result.push_back(record);
+HistoryView ApplicationHistory::getRecordsSince(std::time_t since) const {
+    auto lock = lockLoadedSince(since);
+    HistorySnapshot current = getSnapshot();
+    // Позиции снимка совпадают с позициями records
+    auto first = std::lower_bound(records.begin(), records.end(), since,
+        [](const HistoryRecord& record, std::time_t t) { return record.timestamp < t; });
+
+    size_t from = static_cast<size_t>(first - records.begin());
+    size_t to = current.size();
+    return HistoryView(std::move(current), from, to);
+}
+
+HistoryView ApplicationHistory::getRecordsBetween(std::time_t from, std::time_t to) const {
+    {
+        std::shared_lock<std::shared_mutex> lock(loadMutex);
+        if (from > to) return HistoryView(getSnapshot(), 0, 0);
+
+        // Период целиком раньше загруженных записей: старые сегменты читаются
+        // напрямую, без загрузки всего, что новее, а из архивов распаковываются
+        // только пересекающиеся с периодом блоки
+        if (firstLoadedSegment > 0 && (records.empty() || to < records.front().timestamp)) {
+            return readUnloadedRange(from, to);
         }
     }
-    std::sort(result.begin(), result.end(),
-        [](const HistoryRecord& a, const HistoryRecord& b) {
-            return a.timestamp > b.timestamp;
-        });
-    return result;
-}
\ No newline at end of file
+
+    auto lock = lockLoadedSince(from);
+    HistorySnapshot current = getSnapshot();
+
+    // Позиции снимка совпадают с позициями records
+    auto first = std::lower_bound(records.begin(), records.end(), from,
+        [](const HistoryRecord& record, std::time_t t) { return record.timestamp < t; });
+    auto last = std::upper_bound(first, records.end(), to,
+        [](std::time_t t, const HistoryRecord& record) { return t < record.timestamp; });
+
+    size_t begin = static_cast<size_t>(first - records.begin());
+    size_t end = static_cast<size_t>(last - records.begin());
+    return HistoryView(std::move(current), begin, end);
+}
@@ -2,65 +2,429 @@
 #define APPLICATIONHISTORY_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <ctime>
+#include <memory>
+#include <mutex>
+#include <iterator>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <array>
+#include <utility>
+#include "FileManager.h"
+#include "StringDictionary.h"
+#include "RankedCounter.h"
+#include "HistoryRollup.h"
+#include "BackgroundWriter.h"
+
+class FieldTokenizer;
 
 enum class HistoryAction {
-    CREATED,      //  
-    APPROVED,     //  
-    REJECTED,     //  
-    DELETED,      //  
-    MODIFIED      //  
+    CREATED,      // Заявка создана
+    APPROVED,     // Заявка одобрена
+    REJECTED,     // Заявка отклонена
+    DELETED,      // Заявка удалена
+    MODIFIED      // Заявка изменена
 };
 
+constexpr size_t HISTORY_ACTION_COUNT = 5;
+
+std::string historyActionToString(HistoryAction action);
 
+
+// Запись истории. Строковые поля повторяются из записи в запись (логины,
+// пять видов стипендий, несколько стандартных комментариев), поэтому вместо
+// строк хранятся 32-битные идентификаторы общего словаря истории.
+// Идентификатор 0 - пустая строка.
 struct HistoryRecord {
-    int applicationId;
-    std::string studentUsername;
-    std::string scholarshipType;
-    HistoryAction action;
-    std::string adminUsername;
-    std::string comment;
-    std::time_t timestamp;
+    int applicationId = 0;
+    uint32_t studentId = 0;
+    uint32_t scholarshipTypeId = 0;
+    uint32_t adminId = 0;
+    uint32_t commentId = 0;
+    HistoryAction action = HistoryAction::CREATED;
+    std::time_t timestamp = 0;
+
+    const std::string& getStudentUsername() const { return symbol(studentId); }
+    const std::string& getScholarshipType() const { return symbol(scholarshipTypeId); }
+    const std::string& getAdminUsername() const { return symbol(adminId); }
+    const std::string& getComment() const { return symbol(commentId); }
+
+    void setStudentUsername(std::string_view s) { studentId = intern(s); }
+    void setScholarshipType(std::string_view s) { scholarshipTypeId = intern(s); }
+    void setAdminUsername(std::string_view s) { adminId = intern(s); }
+    void setComment(std::string_view s) { commentId = intern(s); }
 
     std::string toString() const;
     std::string actionToString() const;
+
+    // Общий словарь строк истории (потокобезопасный, только пополняется)
+    static uint32_t intern(std::string_view s);
+    static uint32_t findSymbol(std::string_view s);   // NOT_FOUND, если строки нет
+    static const std::string& symbol(uint32_t id);
+    static size_t symbolCount();
+};
+
+class ApplicationHistory;
+
+// Условия постраничного запроса; пустые поля не ограничивают выборку
+struct HistoryFilter {
+    bool byAction = false;
+    HistoryAction action = HistoryAction::CREATED;
+    std::string student;
+    std::string admin;
+    std::time_t from = 0;                  // включительно
+    std::time_t to = 0;                    // включительно; 0 - без ограничения
+
+    HistoryFilter& withAction(HistoryAction a) { byAction = true; action = a; return *this; }
+    HistoryFilter& withStudent(const std::string& s) { student = s; return *this; }
+    HistoryFilter& withAdmin(const std::string& a) { admin = a; return *this; }
+    HistoryFilter& between(std::time_t f, std::time_t t) { from = f; to = t; return *this; }
+};
+
+// Позиция в истории, с которой продолжается выдача: номер последней выданной
+// записи. Записи только дописываются, поэтому курсор остаётся верным между
+// страницами.
+struct HistoryCursor {
+    size_t position = SIZE_MAX;            // SIZE_MAX - начать с первой записи выдачи
+    bool atStart() const { return position == SIZE_MAX; }
+};
+
+// Страница результатов: записи в порядке запроса и курсор следующей страницы
+struct HistoryPage {
+    std::vector<HistoryRecord> records;
+    HistoryCursor next;
+    bool hasMore = false;
+};
+
+// Ленивый запрос: history.query(filter).after(cursor).limit(k).fetch()
+// просматривает историю с конца и останавливается на k-й подходящей записи,
+// поэтому первая страница не зависит от размера истории. С oldestFirst()
+// записи выдаются от старых к новым; для этого сначала подгружаются все
+// сегменты, начиная с filter.from.
+class HistoryQuery {
+    const ApplicationHistory& history;
+    HistoryFilter filter;
+    HistoryCursor cursor;
+    size_t pageSize;
+    bool forward;
+
+public:
+    HistoryQuery(const ApplicationHistory& h, HistoryFilter f)
+        : history(h), filter(std::move(f)), pageSize(20), forward(false) {}
+
+    HistoryQuery& after(HistoryCursor c) { cursor = c; return *this; }
+    HistoryQuery& limit(size_t k) { pageSize = k > 0 ? k : 1; return *this; }
+    HistoryQuery& oldestFirst() { forward = true; return *this; }
+
+    HistoryPage fetch() const;
+};
+
+// Неизменяемый снимок истории в порядке времени (старые записи первыми).
+// Записи лежат блоками по CHUNK_SIZE, общими для истории и её снимков:
+// заполненные позиции блока больше не меняются, поэтому снимок видит
+// первые size() записей, пока история дописывает следующие в те же блоки.
+class HistorySnapshot {
+public:
+    static constexpr size_t CHUNK_SIZE = 1024;
+    using Chunk = std::shared_ptr<HistoryRecord[]>;
+    using ChunkTable = std::vector<Chunk>;
+
+    HistorySnapshot() : count(0) {}
+    HistorySnapshot(std::shared_ptr<const ChunkTable> table, size_t size)
+        : chunks(std::move(table)), count(size) {}
+    // Снимок из отдельно прочитанных записей
+    static HistorySnapshot fromRecords(const std::vector<HistoryRecord>& records);
+
+    static Chunk makeChunk() { return Chunk(new HistoryRecord[CHUNK_SIZE]); }
+
+    size_t size() const { return count; }
+    const HistoryRecord& operator[](size_t i) const {
+        return (*chunks)[i / CHUNK_SIZE][i % CHUNK_SIZE];
+    }
+
+private:
+    std::shared_ptr<const ChunkTable> chunks;
+    size_t count;
+};
+
+// Результат запроса к истории: записи снимка без копирования - непрерывный
+// диапазон или список позиций. Перебор идёт от новых записей к старым.
+class HistoryView {
+    HistorySnapshot source;
+    std::vector<size_t> positions;   // по возрастанию; используется, если byPositions
+    size_t first;
+    size_t last;
+    bool byPositions;
+
+public:
+    class iterator {
+        const HistoryView* view;
+        size_t index;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = HistoryRecord;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const HistoryRecord*;
+        using reference = const HistoryRecord&;
+
+        iterator(const HistoryView* v, size_t i) : view(v), index(i) {}
+        reference operator*() const { return (*view)[index]; }
+        pointer operator->() const { return &(*view)[index]; }
+        iterator& operator++() { ++index; return *this; }
+        iterator operator++(int) { iterator old = *this; ++index; return old; }
+        bool operator==(const iterator& other) const { return index == other.index; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+    };
+
+    HistoryView() : first(0), last(0), byPositions(false) {}
+    // Диапазон [from, to) снимка
+    HistoryView(HistorySnapshot snapshot, size_t from, size_t to)
+        : source(std::move(snapshot)), first(from), last(to), byPositions(false) {}
+    // Выбранные позиции снимка (по возрастанию)
+    HistoryView(HistorySnapshot snapshot, std::vector<size_t> selected)
+        : source(std::move(snapshot)), positions(std::move(selected)),
+        first(0), last(0), byPositions(true) {}
+
+    size_t size() const { return byPositions ? positions.size() : last - first; }
+    bool empty() const { return size() == 0; }
+
+    // i-я запись, считая от самой новой
+    const HistoryRecord& operator[](size_t i) const {
+        size_t reversed = size() - 1 - i;
+        return source[byPositions ? positions[reversed] : first + reversed];
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size()); }
 };
 
+// История хранится сегментами. Активный сегмент (снимок historyFile и
+// журнал) загружается при старте. Закрытые сегменты - записи одного месяца
+// или не более segmentLimit записей - лежат в отдельных файлах и перечислены
+// в манифесте. Они подгружаются при первом запросе, который до них доходит,
+// всегда непрерывным хвостом: в памяти - сегменты с некоторого и до активного.
+// Сегменты старше archiveAge переводятся в сжатый формат HistoryArchive.
 class ApplicationHistory {
 private:
+    static constexpr size_t ACTION_COUNT = HISTORY_ACTION_COUNT;
+
+    // Закрытый сегмент из манифеста
+    struct Segment {
+        std::string file;
+        std::time_t from = 0;
+        std::time_t to = 0;
+        size_t count = 0;
+        std::array<int, ACTION_COUNT> actions{};   // число записей по действиям
+        // Число записей по студентам и администраторам: пары (идентификатор
+        // общего словаря, записей) по возрастанию идентификатора. По ним
+        // запросы пропускают сегменты, где нужного человека нет
+        std::vector<std::pair<uint32_t, int>> students;
+        std::vector<std::pair<uint32_t, int>> admins;
+        bool indexed = false;   // списки известны (манифест старой версии их не содержит)
+    };
+
+    static void indexSegment(Segment& segment, const HistoryRecord* first, const HistoryRecord* last);
+    static int countIn(const std::vector<std::pair<uint32_t, int>>& list, uint32_t id);
+
     std::vector<HistoryRecord> records;
-    std::string historyFile;
+    std::string historyFile;   // снимок активного сегмента
+    std::string journalFile;   // журнал записей, добавленных после снимка
+    std::string manifestFile;  // список закрытых сегментов
+
+    std::vector<Segment> segments;   // от старых к новым
+    size_t firstLoadedSegment;       // segments[firstLoadedSegment..] в памяти
+    size_t unloadedRecords;          // записей в неподгруженных сегментах
+    size_t sealedRecords;            // записей во всех закрытых сегментах
+    size_t activeStart;              // начало активного сегмента в records
+    size_t segmentLimit;
+    std::time_t archiveAge;          // возраст сегмента для архивации, секунды
+    std::array<int, ACTION_COUNT> unloadedActionCounts{};
+
+    SyncPolicy syncPolicy;
+    int syncInterval;          // для SyncPolicy::Periodic
+    int compactionThreshold;   // записей в журнале до свёртки в снимок
+    int journalCount;
+    int unsyncedCount;
+
+    // Фоновая запись журнала: строки копятся в буфере, а задача writer
+    // дописывает накопленное одним вызовом. Без writer запись синхронная.
+    BackgroundWriter* writer;
+    std::vector<std::string> journalBuffer;
+    bool journalBufferSync;
+    bool journalWriteFailed;   // последняя запись журнала не удалась
+    std::mutex journalBufferMutex;
+
+    bool drainJournal();
+    void discardJournalBuffer();
+    // Дожидается фоновой записи; false, если строки журнала остались незаписанными
+    bool flushWriter();
+
+    // Пакетный режим: строки журнала копятся и пишутся одним вызовом
+    int batchDepth;
+    size_t batchStart;
+    std::vector<std::string> pendingJournal;
+
+    // Индекс студент (идентификатор общего словаря) -> позиции его записей в records
+    std::vector<std::vector<size_t>> recordsByStudent;
+
+    // Полнотекстовый индекс для searchRecords. Термы - различные значения полей
+    // (студент, стипендия, администратор, ID) в нижнем регистре; для каждого
+    // терма хранятся позиции записей, для каждой триграммы - содержащие её термы
+    StringDictionary searchTerms;
+    std::vector<std::vector<size_t>> recordsByTerm;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> termsByTrigram;
+
+    // Терм для строки общего словаря или ID заявки вычисляется один раз
+    std::vector<uint32_t> termBySymbol;
+    std::vector<uint32_t> termByAppId;
+
+    uint32_t internSearchTerm(const std::string& value);
+    uint32_t searchTermForSymbol(uint32_t symbol);
+    uint32_t searchTermForAppId(int appId);
+    void addTermPosition(uint32_t term, size_t pos);
+
+    // Счётчики для статистики, обновляются вместе с индексами в indexRecord.
+    // Ключи - идентификаторы общего словаря из самих записей, поэтому
+    // индексирование не обращается к строкам. Счётчики студентов и
+    // администраторов учитывают и неподгруженные сегменты (по манифесту)
+    std::array<int, ACTION_COUNT> actionCounts{};
+    RankedCounter studentCounts;
+    RankedCounter adminCounts;
+    HistoryRollup rollup;          // счётчики по дням, неделям и семестрам
+
+    static std::vector<std::pair<std::string, int>> topOf(const RankedCounter& counter, size_t k);
+    const std::vector<size_t>* studentPositions(const std::string& username) const;
+
+    // Блоки снимков с копией records (см. HistorySnapshot). Новая запись
+    // дописывается в последний блок; после других изменений records таблица
+    // сбрасывается и собирается заново первым читателем. Таблица не меняется
+    // после публикации: новый блок добавляется в её копию.
+    mutable std::shared_ptr<const HistorySnapshot::ChunkTable> snapshotChunks;
+    mutable std::mutex snapshotMutex;
+
+    void invalidateSnapshot();
+    void appendToSnapshot(const HistoryRecord& record);
+    HistorySnapshot getSnapshot() const;
+
+    friend class HistoryQuery;
+    HistoryPage fetchPage(const HistoryFilter& filter, HistoryCursor cursor, size_t limit, bool forward) const;
+
+    // counted - запись уже учтена в счётчиках студентов и администраторов
+    void indexRecord(size_t pos, bool counted = false);
+    void rebuildIndex();
+    void indexPrepended(size_t inserted);
 
     void loadFromFile();
-    void saveToFile() const;
+    bool saveToFile() const;
+
+    // Сегменты
+    void loadManifest();
+    bool saveManifest() const;
+    std::string segmentPath(const std::string& name) const;
+    bool readSegment(const Segment& segment, std::vector<HistoryRecord>& out) const;
+    void loadSegments(size_t first);
+    size_t firstSegmentSince(std::time_t from) const;
+    // Ленивая подгрузка сегментов из const-запросов меняет записи и индексы,
+    // поэтому запросы читают их под общей блокировкой loadMutex, а подгрузка
+    // идёт под исключительной. Изменения истории (не const) по-прежнему
+    // синхронизирует вызывающий код.
+    mutable std::shared_mutex loadMutex;
+    std::shared_lock<std::shared_mutex> lockLoadedSince(std::time_t from) const;
+    std::shared_lock<std::shared_mutex> lockAllLoaded() const { return lockLoadedSince(0); }
+    bool loadOlderSegments(size_t expectedFirst, std::time_t from) const;
+    bool needsRotation() const;
+    void rotateSegments();
+    bool sealSegment(size_t begin, size_t end);
+    void archiveSegments();
+    HistoryView readUnloadedRange(std::time_t from, std::time_t to) const;
+    // Записи match из неподгруженных сегментов, отобранных по манифесту (wanted),
+    // вместе с позициями positions загруженных записей; вызывается под loadMutex
+    template<typename SegmentFilter, typename RecordFilter>
+    HistoryView withUnloaded(SegmentFilter wanted, RecordFilter match,
+        HistorySnapshot current, std::vector<size_t> positions) const;
+    bool collectPage(const HistoryFilter& filter, size_t low, size_t high, bool forward,
+        size_t limit, HistoryPage& page) const;
+
+    static std::string serializeRecords(const HistoryRecord* first, const HistoryRecord* last, size_t base);
+    static bool readSnapshot(const std::string& filename, std::vector<HistoryRecord>& out, long long& base);
+    void appendToJournal(const HistoryRecord& record);
+
+    static std::string formatRecord(const HistoryRecord& record);
+    static bool parseRecord(FieldTokenizer& fields, HistoryRecord& record);
+    static bool parseEncodedRecord(FieldTokenizer& fields,
+        const std::vector<uint32_t>& symbols, HistoryRecord& record);
 
 public:
     ApplicationHistory(const std::string& filename = "history.txt");
+    ~ApplicationHistory();
+
+    // Дозапись журнала через фоновый поток; writer должен пережить историю
+    void setWriter(BackgroundWriter* backgroundWriter);
+    // Дожидается записи журнала. false, пока в буфере остаются строки,
+    // которые не удалось записать; каждый вызов повторяет их запись
+    bool flushJournal();
 
-    //  
+    // Настройка журнала
+    void setSyncPolicy(SyncPolicy policy, int interval = 16);
+    void setCompactionThreshold(int threshold) { compactionThreshold = threshold; }
+    // Свёртка журнала в снимок
+    void compact();
+
+    // Наибольшее число записей в сегменте (помимо разбиения по месяцам)
+    void setSegmentLimit(size_t limit) { segmentLimit = limit > 0 ? limit : 1; }
+    // Сегменты, закрытые раньше чем days дней назад, сжимаются при следующей ротации
+    void setArchiveAge(int days) { archiveAge = static_cast<std::time_t>(days > 0 ? days : 0) * 24 * 60 * 60; }
+    // Загрузка всех сегментов заранее, чтобы первые запросы не ждали диска
+    void loadAllSegments() { lockAllLoaded(); }
+    size_t getSegmentCount() const { return segments.size(); }
+    size_t getLoadedSegmentCount() const;
+
+    // Пакетное добавление записей (допускается вложенность)
+    void beginBatch();
+    bool commitBatch();
+    void rollbackBatch();
+
+    // Добавление записи
     void addRecord(int appId, const std::string& student,
         const std::string& scholarship, HistoryAction action,
         const std::string& admin = "", const std::string& comment = "");
 
-    //  
-    std::vector<HistoryRecord> getAllRecords() const;
-    std::vector<HistoryRecord> getRecordsByStudent(const std::string& username) const;
-    std::vector<HistoryRecord> getRecordsByAction(HistoryAction action) const;
-    std::vector<HistoryRecord> getRecordsByAdmin(const std::string& admin) const;
+    // Получение истории (записи хранятся в порядке времени, поэтому
+    // результаты не сортируются, а перебираются от новых к старым)
+    HistoryView getAllRecords() const;
+    HistoryView getRecordsByStudent(const std::string& username) const;
+    HistoryView getRecordsByAction(HistoryAction action) const;
+    HistoryView getRecordsByAdmin(const std::string& admin) const;
+
+    // Фильтрация по дате (двоичный поиск)
+    HistoryView getRecordsSince(std::time_t since) const;
+    HistoryView getRecordsBetween(std::time_t from, std::time_t to) const;
 
-    //   
-    std::vector<HistoryRecord> getRecordsSince(std::time_t since) const;
-    std::vector<HistoryRecord> getRecordsBetween(std::time_t from, std::time_t to) const;
+    // Поиск записи
+    HistoryView searchRecords(const std::string& keyword) const;
 
-    //  
-    std::vector<HistoryRecord> searchRecords(const std::string& keyword) const;
+    // Постраничный запрос по фильтру
+    HistoryQuery query(const HistoryFilter& filter = HistoryFilter()) const {
+        return HistoryQuery(*this, filter);
+    }
 
-    // 
-    int getTotalCount() const { return static_cast<int>(records.size()); }
+    // Статистика
+    int getTotalCount() const;
     int getActionCount(HistoryAction action) const;
+    int getStudentRecordCount(const std::string& username) const;
+    int getAdminRecordCount(const std::string& admin) const;
+    // Самые активные студенты и администраторы: (логин, число записей)
+    std::vector<std::pair<std::string, int>> getTopStudents(size_t k) const;
+    std::vector<std::pair<std::string, int>> getTopAdmins(size_t k) const;
+    // Агрегаты по периодам (см. HistoryRollup). Подгружаются только сегменты,
+    // пересекающие корзины периода; строки собираются под блокировкой подгрузки
+    std::vector<RollupRow> queryRollup(RollupGranularity granularity, std::time_t from, std::time_t to,
+        const RollupFilter& filter = RollupFilter(), RollupGroup group = RollupGroup::None) const;
 
-    //  
+    // Очистка истории
     void clearHistory();
 };
 
@@ -1,167 +1,418 @@
 #include "ApplicationManager.h"
 #include "FileManager.h"
 #include "ScholarshipType.h"
+#include "ApplicationSnapshot.h"
+#include "Logger.h"
 #include <algorithm>
+#include <filesystem>
 #include <sstream>
-#include <iostream>  
+#include <chrono>
 
-ApplicationManager::ApplicationManager(const std::string& filename)
-    : applicationsFile(filename), history("history.txt") {
+ApplicationManager::ApplicationManager(const std::string& filename, StorageFormat format)
+    : applicationsFile(filename), storageFormat(format), history("history.txt"),
+    batchDepth(0), pendingSave(false) {
+    snapshotFile = std::filesystem::path(filename).replace_extension(".bin").string();
+    history.setWriter(&writer);
     loadApplications();
 }
 
+ApplicationManager::~ApplicationManager() {
+    if (!flushSaves()) {
+        LOG_ERROR("ApplicationManager", "Последние изменения заявок не записаны в " << applicationsFile);
+    }
+}
+
 void ApplicationManager::loadApplications() {
+    // Незаписанные сохранения иначе перезаписали бы прочитанный файл
+    if (!flushSaves()) {
+        LOG_WARN("ApplicationManager", "Изменения заявок не были записаны и заменяются данными файла");
+    }
     applications.clear();
-    auto lines = FileManager::readLines(applicationsFile);
+    auto started = std::chrono::steady_clock::now();
+    auto logLoaded = [&](const std::string& source) {
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - started).count();
+        LOG_INFO("ApplicationManager", "Заявки загружены: applications=" << applications.size()
+            << " source=" << source << " ms=" << ms);
+    };
 
-    int maxId = 0;  
+    if (storageFormat == StorageFormat::Binary && std::filesystem::exists(snapshotFile)) {
+        std::string error;
+        if (ApplicationSnapshot::load(snapshotFile, applications, error)) {
+            finishLoad();
+            logLoaded(snapshotFile);
+            return;
+        }
+        LOG_WARN("ApplicationManager", "Ошибка чтения снимка " << snapshotFile << ": " << error
+            << ". Загружаем " << applicationsFile);
+        applications.clear();
+    }
 
-    for (const auto& line : lines) {
-        if (line.empty()) continue;
+    loadText(applicationsFile);
+    finishLoad();
+    logLoaded(applicationsFile);
+}
 
-        try {
-            Application app;
-            if (app.loadFromString(line)) {
-                applications.push_back(app);
-                if (app.getId() > maxId) {
-                    maxId = app.getId();
-                }
-            }
+bool ApplicationManager::loadText(const std::string& filename) {
+    std::string error;
+    return FileManager::forEachLine(filename, [&](std::string_view line, size_t lineNumber) {
+        Application app;
+        if (!app.loadFromString(line, &error)) {
+            LOG_WARN("ApplicationManager", "Ошибка разбора " << filename << ", строка "
+                << lineNumber << ": " << error << ". Заявка пропущена");
+            return;
         }
-        catch (...) {
+        applications.push_back(std::move(app));
+        });
+}
+
+void ApplicationManager::finishLoad() {
+    int maxId = 0;
+    for (const auto& app : applications) {
+        if (app.getId() > maxId) {
+            maxId = app.getId();
         }
     }
     if (maxId > 0) {
         Application::setNextId(maxId + 1);
     }
+    rebuildIndex();
+    publishSnapshot();
 }
 
-void ApplicationManager::saveApplications() const {
+bool ApplicationManager::exportText(const std::string& filename) const {
+    return writeText(filename, getAllApplications());
+}
+
+bool ApplicationManager::writeText(const std::string& filename, const ApplicationsSnapshot& apps) {
     std::vector<std::string> lines;
+    lines.reserve(apps.size());
 
-    for (const auto& app : applications) {
+    for (const auto& app : apps) {
         lines.push_back(app.saveToString());
     }
 
-    FileManager::writeLines(applicationsFile, lines);
+    return FileManager::writeLines(filename, lines);
 }
 
-bool ApplicationManager::addApplication(const Application& app) {
-    for (const auto& existingApp : applications) {
-        if (existingApp.getId() == app.getId()) {
+bool ApplicationManager::importText(const std::string& filename) {
+    if (!std::filesystem::exists(filename)) {
+        return false;
+    }
+    applications.clear();
+    loadText(filename);
+    finishLoad();
+    saveApplications();
+    return true;
+}
+
+bool ApplicationManager::flushSaves() {
+    uint64_t task = lastSaveTask.load();
+    if (task == 0) {
+        writer.wait();
+        return true;
+    }
+    return writer.flush(task);
+}
+
+bool ApplicationManager::flush() {
+    bool written = flushSaves();
+    // Журнал истории проверяется отдельно: его строки не пропадают при
+    // ошибке, а ждут повторной записи
+    return history.flushJournal() && written;
+}
+
+int ApplicationManager::findSlot(int id) const {
+    if (id <= 0) return -1;
+    if (static_cast<size_t>(id) < slotById.size() && slotById[id] >= 0) return slotById[id];
+    if (sparseSlots.empty()) return -1;
+    auto it = sparseSlots.find(id);
+    return it != sparseSlots.end() ? it->second : -1;
+}
+
+void ApplicationManager::indexSlot(size_t slot) {
+    int id = applications[slot].getId();
+    if (id <= 0) return;
+
+    size_t denseLimit = std::max(DENSE_IDS_MIN, applications.size() * DENSE_IDS_PER_APPLICATION);
+    if (static_cast<size_t>(id) >= denseLimit) {
+        sparseSlots[id] = static_cast<int>(slot);
+        return;
+    }
+    if (static_cast<size_t>(id) >= slotById.size()) {
+        slotById.resize(static_cast<size_t>(id) + 1, -1);
+    }
+    slotById[id] = static_cast<int>(slot);
+    // ID мог попасть в sparseSlots, пока заявок было меньше
+    if (!sparseSlots.empty()) sparseSlots.erase(id);
+}
+
+void ApplicationManager::unindexSlot(int id) {
+    if (id > 0 && static_cast<size_t>(id) < slotById.size()) slotById[id] = -1;
+    sparseSlots.erase(id);
+}
+
+void ApplicationManager::reindexFrom(size_t slot) {
+    for (size_t i = slot; i < applications.size(); ++i) {
+        indexSlot(i);
+    }
+}
+
+void ApplicationManager::rebuildIndex() {
+    slotById.clear();
+    sparseSlots.clear();
+    reindexFrom(0);
+
+    studentNames.clear();
+    appIdsByStudent.clear();
+    for (const auto& app : applications) {
+        indexStudent(app);
+    }
+}
+
+const std::vector<int>* ApplicationManager::findStudentApps(const std::string& username) const {
+    uint32_t sym = studentNames.find(username);
+    if (sym == StringDictionary::NOT_FOUND) return nullptr;
+    return &appIdsByStudent[sym];
+}
+
+void ApplicationManager::indexStudent(const Application& app) {
+    uint32_t sym = studentNames.intern(app.getStudentUsername());
+    if (sym >= appIdsByStudent.size()) {
+        appIdsByStudent.resize(sym + 1);
+    }
+    appIdsByStudent[sym].push_back(app.getId());
+}
+
+void ApplicationManager::unindexStudent(const Application& app) {
+    uint32_t sym = studentNames.find(app.getStudentUsername());
+    if (sym == StringDictionary::NOT_FOUND) return;
+    auto& ids = appIdsByStudent[sym];
+    ids.erase(std::remove(ids.begin(), ids.end(), app.getId()), ids.end());
+}
+
+void ApplicationManager::saveApplications() const {
+    if (batchDepth > 0) {
+        pendingSave = true;
+        return;
+    }
+
+    // Задача получает неизменяемый снимок таблицы, поэтому интерактивный
+    // поток не ждёт диска и может менять заявки дальше
+    ApplicationsSnapshot current = getAllApplications();
+    StorageFormat format = storageFormat;
+    lastSaveTask = writer.submit(applicationsFile, [this, current, format]() {
+        return writeApplications(current, format);
+        });
+}
+
+bool ApplicationManager::writeApplications(const ApplicationsSnapshot& apps, StorageFormat format) const {
+    if (format == StorageFormat::Binary) {
+        return ApplicationSnapshot::save(snapshotFile, apps);
+    }
+    return writeText(applicationsFile, apps);
+}
+
+void ApplicationManager::beginBatch() {
+    if (batchDepth++ == 0) {
+        batchBackup = applications;
+        pendingSave = false;
+    }
+    history.beginBatch();
+}
+
+bool ApplicationManager::commitBatch() {
+    if (batchDepth == 0) return false;
+    if (--batchDepth > 0) {
+        history.commitBatch();
+        return true;
+    }
+
+    // Пакет пишется синхронно, чтобы при ошибке его можно было откатить;
+    // ранее поставленные сохранения не должны перезаписать его позже.
+    // Если последнее из них не удалось, таблица переписывается вместе с пакетом
+    if (!flushSaves()) pendingSave = true;
+    if (pendingSave) {
+        if (!writeApplications(getAllApplications(), storageFormat)) {
+            batchDepth = 1;
+            rollbackBatch();
             return false;
         }
+        // Файл совпадает с памятью - прежние ошибки фоновых сохранений уже не важны
+        lastSaveTask = 0;
+    }
+
+    if (!history.commitBatch()) {
+        // История не записалась - возвращаем и память, и файл заявок
+        applications.swap(batchBackup);
+        rebuildIndex();
+        publishSnapshot();
+        if (pendingSave && !writeApplications(getAllApplications(), storageFormat))
+            LOG_ERROR("ApplicationManager", "Не удалось вернуть прежнее содержимое " << applicationsFile);
+        pendingSave = false;
+        batchBackup.clear();
+        return false;
+    }
+
+    pendingSave = false;
+    batchBackup.clear();
+    return true;
+}
+
+void ApplicationManager::rollbackBatch() {
+    if (batchDepth == 0) return;
+    batchDepth = 0;
+
+    applications.swap(batchBackup);
+    batchBackup.clear();
+    rebuildIndex();
+    publishSnapshot();
+    pendingSave = false;
+    history.rollbackBatch();
+}
+
+bool ApplicationManager::addApplication(const Application& app) {
+    if (findSlot(app.getId()) >= 0) {
+        return false;
     }
     history.addRecord(app.getId(), app.getStudentUsername(),
         ScholarshipType::categoryToString(app.getScholarshipCategory()),
-        HistoryAction::CREATED, "", " ");
+        HistoryAction::CREATED, "", "Заявка создана");
 
     applications.push_back(app);
+    indexSlot(applications.size() - 1);
+    indexStudent(app);
+    publishSnapshot(applications.size() - 1, applications.size());
     saveApplications();
 
     return true;
 }
 
 bool ApplicationManager::removeApplicationById(int id, const std::string& deleter) {
-    for (auto it = applications.begin(); it != applications.end(); ++it) {
-        if (it->getId() == id) {
-            history.addRecord(id, it->getStudentUsername(),
-                ScholarshipType::categoryToString(it->getScholarshipCategory()),
-                HistoryAction::DELETED, deleter, " ");
-
-            applications.erase(it);
-            saveApplications();
-            return true;
-        }
-    }
-    return false;
-}
+    int slot = findSlot(id);
+    if (slot < 0) return false;
 
-bool ApplicationManager::removeApplicationsByStudent(const std::string& username) {
-    bool removed = false;
+    auto it = applications.begin() + slot;
+    history.addRecord(id, it->getStudentUsername(),
+        ScholarshipType::categoryToString(it->getScholarshipCategory()),
+        HistoryAction::DELETED, deleter, "Заявка удалена");
 
-    for (auto it = applications.begin(); it != applications.end();) {
-        if (it->getStudentUsername() == username) {
-            history.addRecord(it->getId(), username,
-                ScholarshipType::categoryToString(it->getScholarshipCategory()),
-                HistoryAction::DELETED, "system", "    ");
+    unindexStudent(*it);
+    applications.erase(it);
+    unindexSlot(id);
+    reindexFrom(static_cast<size_t>(slot));
+    publishSnapshot(static_cast<size_t>(slot));
+    saveApplications();
+    return true;
+}
 
-            it = applications.erase(it);
-            removed = true;
-        }
-        else {
-            ++it;
-        }
+bool ApplicationManager::removeApplicationsByStudent(const std::string& username) {
+    const std::vector<int>* ids = findStudentApps(username);
+    if (!ids || ids->empty()) {
+        return false;
     }
 
-    if (removed) {
-        saveApplications();
+    history.beginBatch();
+    for (int id : *ids) {
+        const Application& app = applications[findSlot(id)];
+        history.addRecord(id, username,
+            ScholarshipType::categoryToString(app.getScholarshipCategory()),
+            HistoryAction::DELETED, "system", "Заявка удалена вместе со студентом");
     }
-    return removed;
+    if (!history.commitBatch()) {
+        // Записи об удалении не попали в журнал - заявки остаются на месте
+        LOG_ERROR("ApplicationManager", "Заявки студента " << username
+            << " не удалены: не удалось записать историю");
+        return false;
+    }
+
+    applications.erase(std::remove_if(applications.begin(), applications.end(),
+        [&username](const Application& app) {
+            return app.getStudentUsername() == username;
+        }), applications.end());
+
+    rebuildIndex();
+    publishSnapshot();
+    saveApplications();
+    return true;
 }
 
 bool ApplicationManager::updateApplicationStatusById(int id, ApplicationStatus newStatus,
     const std::string& adminUsername) {
-    for (auto& app : applications) {
-        if (app.getId() == id) {
-            HistoryAction action = (newStatus == ApplicationStatus::Approved) ?
-                HistoryAction::APPROVED : HistoryAction::REJECTED;
-
-            history.addRecord(id, app.getStudentUsername(),
-                ScholarshipType::categoryToString(app.getScholarshipCategory()),
-                action, adminUsername, " ");
-
-            app.setStatus(newStatus);
-            saveApplications();
-            return true;
+    int slot = findSlot(id);
+    if (slot < 0) return false;
+
+    Application& app = applications[slot];
+    HistoryAction action = (newStatus == ApplicationStatus::Approved) ?
+        HistoryAction::APPROVED : HistoryAction::REJECTED;
+
+    history.addRecord(id, app.getStudentUsername(),
+        ScholarshipType::categoryToString(app.getScholarshipCategory()),
+        action, adminUsername, "Изменение статуса");
+
+    app.setStatus(newStatus);
+    publishSnapshot(static_cast<size_t>(slot), static_cast<size_t>(slot) + 1);
+    saveApplications();
+    return true;
+}
+
+void ApplicationManager::publishSnapshot(size_t first, size_t last) {
+    const size_t chunkSize = ApplicationsSnapshot::CHUNK_SIZE;
+    const size_t total = applications.size();
+    last = std::min(last, total);
+
+    std::shared_ptr<const ApplicationsSnapshot::ChunkTable> previous = std::atomic_load(&snapshotChunks);
+    auto table = std::make_shared<ApplicationsSnapshot::ChunkTable>();
+    table->reserve((total + chunkSize - 1) / chunkSize);
+    for (size_t begin = 0; begin < total; begin += chunkSize) {
+        size_t end = std::min(begin + chunkSize, total);
+        size_t index = begin / chunkSize;
+        bool touched = begin < last && first < end;
+        if (!touched && previous && index < previous->size() &&
+            (*previous)[index]->size() == end - begin) {
+            table->push_back((*previous)[index]);
+            continue;
         }
+        table->push_back(std::make_shared<const std::vector<Application>>(
+            applications.begin() + begin, applications.begin() + end));
     }
-    return false;
+
+    std::shared_ptr<const ApplicationsSnapshot::ChunkTable> published = std::move(table);
+    std::atomic_store(&snapshotChunks, published);
 }
 
-std::vector<Application> ApplicationManager::getAllApplications() const {
-    return applications;
+ApplicationsSnapshot ApplicationManager::getAllApplications() const {
+    return ApplicationsSnapshot(std::atomic_load(&snapshotChunks));
 }
 
 std::vector<Application> ApplicationManager::getApplicationsByStudent(const std::string& username) const {
     std::vector<Application> result;
 
-    for (const auto& app : applications) {
-        if (app.getStudentUsername() == username) {
-            result.push_back(app);
-        }
+    const std::vector<int>* ids = findStudentApps(username);
+    if (!ids) return result;
+
+    result.reserve(ids->size());
+    for (int id : *ids) {
+        result.push_back(applications[findSlot(id)]);
     }
 
     return result;
 }
 
-Application* ApplicationManager::getApplicationById(int id) {
-    for (auto& app : applications) {
-        if (app.getId() == id) {
-            return &app;
-        }
-    }
-    return nullptr;
-}
-
 const Application* ApplicationManager::getApplicationById(int id) const {
-    for (const auto& app : applications) {
-        if (app.getId() == id) {
-            return &app;
-        }
-    }
-    return nullptr;
+    int slot = findSlot(id);
+    return slot >= 0 ? &applications[slot] : nullptr;
 }
 
 std::vector<Application> ApplicationManager::searchApplications(double minAvg, double maxAvg, int statusFilter) const {
     std::vector<Application> result;
 
     for (const auto& app : applications) {
-        //   
+        // Фильтр по баллу
         if (app.getAverageGrade() < minAvg || app.getAverageGrade() > maxAvg) {
             continue;
         }
-        //   
+        // Фильтр по статусу
         if (statusFilter != 0) {
             int appStatus = static_cast<int>(app.getStatus());
             if (appStatus != statusFilter) {
@@ -176,9 +427,11 @@ std::vector<Application> ApplicationManager::searchApplications(double minAvg, d
 int ApplicationManager::getPendingApplicationsCount(const std::string& username) const {
     int count = 0;
 
-    for (const auto& app : applications) {
-        if (app.getStudentUsername() == username &&
-            app.getStatus() == ApplicationStatus::Pending) {
+    const std::vector<int>* ids = findStudentApps(username);
+    if (!ids) return 0;
+
+    for (int id : *ids) {
+        if (applications[findSlot(id)].getStatus() == ApplicationStatus::Pending) {
             count++;
         }
     }
@@ -3,21 +3,149 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <atomic>
+#include <iterator>
+#include <cstdint>
+#include <unordered_map>
 #include "Application.h"
 #include "ScholarshipType.h"  
 #include "ApplicationHistory.h"  
+#include "StringDictionary.h"
+#include "BackgroundWriter.h"
+
+// Формат хранения таблицы заявок
+enum class StorageFormat {
+    Text,     // applications.txt, строки "id|логин|балл|категория|статус"
+    Binary    // колоночный снимок applications.bin (см. ApplicationSnapshot)
+};
+
+// Неизменяемый снимок таблицы заявок. Держатель снимка видит согласованное
+// состояние, даже если после его получения таблица изменилась.
+// Заявки лежат неизменяемыми блоками по CHUNK_SIZE (последний может быть
+// неполным); новая версия таблицы разделяет с прежней все блоки, которых
+// изменение не коснулось.
+class ApplicationsSnapshot {
+public:
+    static constexpr size_t CHUNK_SIZE = 1024;
+    using Chunk = std::shared_ptr<const std::vector<Application>>;
+    using ChunkTable = std::vector<Chunk>;
+
+    class iterator {
+        const ApplicationsSnapshot* snapshot;
+        size_t index;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Application;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Application*;
+        using reference = const Application&;
+
+        iterator(const ApplicationsSnapshot* s, size_t i) : snapshot(s), index(i) {}
+        reference operator*() const { return (*snapshot)[index]; }
+        pointer operator->() const { return &(*snapshot)[index]; }
+        iterator& operator++() { ++index; return *this; }
+        iterator operator++(int) { iterator old = *this; ++index; return old; }
+        bool operator==(const iterator& other) const { return index == other.index; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+    };
+
+    ApplicationsSnapshot() : count(0) {}
+    explicit ApplicationsSnapshot(std::shared_ptr<const ChunkTable> table)
+        : chunks(std::move(table)),
+        count(chunks && !chunks->empty() ? (chunks->size() - 1) * CHUNK_SIZE + chunks->back()->size() : 0) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Application& operator[](size_t i) const {
+        return (*(*chunks)[i / CHUNK_SIZE])[i % CHUNK_SIZE];
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, count); }
+
+private:
+    std::shared_ptr<const ChunkTable> chunks;
+    size_t count;
+};
 
 class ApplicationManager {
 private:
     std::vector<Application> applications;
     std::string applicationsFile;
+    std::string snapshotFile;
+    StorageFormat storageFormat;
+    // Фоновая запись файла заявок и журнала истории. Объявлен до history:
+    // поток записи должен пережить историю, чьи задачи он выполняет
+    mutable BackgroundWriter writer;
     ApplicationHistory history;
+    // Номер последней задачи сохранения заявок. Каждое сохранение пишет
+    // таблицу целиком, поэтому изменения на диске, если удалась она
+    mutable std::atomic<uint64_t> lastSaveTask{ 0 };
+    bool flushSaves();
+
+    // Индекс ID -> позиция в applications. ID выдаются монотонно
+    // (Application::nextId), поэтому обычно хватает плотной таблицы; -1 - нет
+    // заявки. Таблица растёт не дальше DENSE_IDS_PER_APPLICATION ID на заявку:
+    // выбросы (например, испорченный ID в файле) попадают в sparseSlots.
+    static constexpr size_t DENSE_IDS_PER_APPLICATION = 4;
+    static constexpr size_t DENSE_IDS_MIN = 4096;
+    std::vector<int> slotById;
+    std::unordered_map<int, int> sparseSlots;
+
+    // Индекс логин студента -> ID его заявок (в порядке добавления)
+    StringDictionary studentNames;
+    std::vector<std::vector<int>> appIdsByStudent;
+
+    // Пакетный режим: состояние до начала пакета и отложенное сохранение
+    int batchDepth;
+    mutable bool pendingSave;
+    std::vector<Application> batchBackup;
+
+    // Таблица блоков текущего снимка (см. ApplicationsSnapshot). Каждое
+    // изменение заявок собирает заново только затронутые блоки и публикует
+    // новую таблицу через std::atomic_store; читатели берут её atomic_load
+    // без блокировок
+    std::shared_ptr<const ApplicationsSnapshot::ChunkTable> snapshotChunks;
+
+    // Пересобирает блоки, пересекающие позиции [first, last) applications,
+    // и блоки, размер которых изменился; остальные берутся из прежней версии
+    void publishSnapshot(size_t first = 0, size_t last = SIZE_MAX);
+
+    // Вызывается и из потока записи: читает только apps и имена файлов
+    bool writeApplications(const ApplicationsSnapshot& apps, StorageFormat format) const;
+    static bool writeText(const std::string& filename, const ApplicationsSnapshot& apps);
+    bool loadText(const std::string& filename);
+    void finishLoad();
+
+    int findSlot(int id) const;
+    const std::vector<int>* findStudentApps(const std::string& username) const;
+    void indexStudent(const Application& app);
+    void unindexStudent(const Application& app);
+    void indexSlot(size_t slot);
+    void unindexSlot(int id);
+    void reindexFrom(size_t slot);
+    void rebuildIndex();
 
 public:
-    ApplicationManager(const std::string& filename = "applications.txt");
+    ApplicationManager(const std::string& filename = "applications.txt",
+        StorageFormat format = StorageFormat::Text);
+    ~ApplicationManager();
 
     void loadApplications();
+    // Сохранение ставится в очередь фоновой записи; несколько сохранений
+    // подряд сливаются в одно
     void saveApplications() const;
+    // Дожидается записи на диск всех сделанных изменений
+    bool flush();
+    WriterMetrics getWriterMetrics() const { return writer.metrics(); }
+
+    // Формат хранения: при Binary основным становится снимок applications.bin,
+    // а текстовый файл остаётся путём экспорта и импорта
+    void setStorageFormat(StorageFormat format) { storageFormat = format; }
+    StorageFormat getStorageFormat() const { return storageFormat; }
+    bool exportText(const std::string& filename) const;
+    bool importText(const std::string& filename);
 
     bool addApplication(const Application& app);
     bool removeApplicationById(int id, const std::string& deleter = "");
@@ -26,16 +154,39 @@ public:
     bool updateApplicationStatusById(int id, ApplicationStatus newStatus,
         const std::string& adminUsername = "");
 
-    std::vector<Application> getAllApplications() const;
+    // Без копирования и блокировок
+    ApplicationsSnapshot getAllApplications() const;
     std::vector<Application> getApplicationsByStudent(const std::string& username) const;
-    Application* getApplicationById(int id);
+    // Только для чтения: заявки меняются методами менеджера, которые
+    // обновляют индексы и публикуют новый снимок
     const Application* getApplicationById(int id) const;
 
     std::vector<Application> searchApplications(double minAvg, double maxAvg, int statusFilter = 0) const;
 
     int getPendingApplicationsCount(const std::string& username) const;
 
-    //     
+    // Пакетные изменения: операции применяются в памяти, а applications.txt
+    // и журнал истории сохраняются один раз при commitBatch
+    void beginBatch();
+    bool commitBatch();
+    void rollbackBatch();
+    bool inBatch() const { return batchDepth > 0; }
+
+    // RAII-обёртка над пакетом: незафиксированный пакет откатывается
+    class Batch {
+        ApplicationManager& manager;
+        bool finished;
+    public:
+        explicit Batch(ApplicationManager& m) : manager(m), finished(false) { manager.beginBatch(); }
+        ~Batch() { if (!finished) manager.rollbackBatch(); }
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+        bool commit() { finished = true; return manager.commitBatch(); }
+        void rollback() { finished = true; manager.rollbackBatch(); }
+    };
+
+    // Метод для доступа к истории
     ApplicationHistory& getHistory() { return history; }
     const ApplicationHistory& getHistory() const { return history; }
 };
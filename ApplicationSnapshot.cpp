@@ -0,0 +1,144 @@
+#include "ApplicationSnapshot.h"
+#include "ApplicationManager.h"
+#include "FileManager.h"
+#include <cstring>
+#include <cstdint>
+
+namespace {
+    struct SnapshotHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint32_t heapSize;
+    };
+
+    const char MAGIC[4] = { 'A', 'P', 'P', 'S' };
+
+    size_t columnsSize(size_t count) {
+        return count * (sizeof(double) + sizeof(int32_t) + 2 * sizeof(uint32_t) + 2 * sizeof(uint8_t));
+    }
+
+    template <typename T>
+    void putColumn(std::string& out, size_t& offset, size_t index, T value) {
+        std::memcpy(&out[offset + index * sizeof(T)], &value, sizeof(T));
+    }
+
+    template <typename T>
+    T getColumn(const char* column, size_t index) {
+        T value;
+        std::memcpy(&value, column + index * sizeof(T), sizeof(T));
+        return value;
+    }
+}
+
+bool ApplicationSnapshot::save(const std::string& filename, const ApplicationsSnapshot& applications) {
+    const size_t count = applications.size();
+
+    size_t heapSize = 0;
+    for (const auto& app : applications) {
+        heapSize += app.getStudentUsername().size();
+    }
+
+    std::string data(sizeof(SnapshotHeader) + columnsSize(count) + heapSize, '\0');
+
+    SnapshotHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.count = static_cast<uint32_t>(count);
+    header.heapSize = static_cast<uint32_t>(heapSize);
+    std::memcpy(&data[0], &header, sizeof(header));
+
+    size_t gradeCol = sizeof(SnapshotHeader);
+    size_t idCol = gradeCol + count * sizeof(double);
+    size_t offsetCol = idCol + count * sizeof(int32_t);
+    size_t lengthCol = offsetCol + count * sizeof(uint32_t);
+    size_t categoryCol = lengthCol + count * sizeof(uint32_t);
+    size_t statusCol = categoryCol + count * sizeof(uint8_t);
+    size_t heapStart = statusCol + count * sizeof(uint8_t);
+
+    uint32_t heapPos = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Application& app = applications[i];
+        const std::string& name = app.getStudentUsername();
+
+        putColumn<double>(data, gradeCol, i, app.getAverageGrade());
+        putColumn<int32_t>(data, idCol, i, app.getId());
+        putColumn<uint32_t>(data, offsetCol, i, heapPos);
+        putColumn<uint32_t>(data, lengthCol, i, static_cast<uint32_t>(name.size()));
+        putColumn<uint8_t>(data, categoryCol, i, static_cast<uint8_t>(app.getScholarshipCategory()));
+        putColumn<uint8_t>(data, statusCol, i, static_cast<uint8_t>(app.getStatus()));
+
+        std::memcpy(&data[heapStart + heapPos], name.data(), name.size());
+        heapPos += static_cast<uint32_t>(name.size());
+    }
+
+    return FileManager::writeData(filename, data);
+}
+
+bool ApplicationSnapshot::load(const std::string& filename, std::vector<Application>& applications,
+    std::string& error) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        error = "не удалось открыть файл";
+        return false;
+    }
+
+    std::string_view data = file.data();
+    SnapshotHeader header;
+    if (data.size() < sizeof(header)) {
+        error = "файл короче заголовка";
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = "неверная сигнатура";
+        return false;
+    }
+    if (header.version != VERSION) {
+        error = "неподдерживаемая версия " + std::to_string(header.version);
+        return false;
+    }
+
+    const size_t count = header.count;
+    if (data.size() != sizeof(header) + columnsSize(count) + header.heapSize) {
+        error = "размер файла не соответствует заголовку";
+        return false;
+    }
+
+    const char* gradeCol = data.data() + sizeof(header);
+    const char* idCol = gradeCol + count * sizeof(double);
+    const char* offsetCol = idCol + count * sizeof(int32_t);
+    const char* lengthCol = offsetCol + count * sizeof(uint32_t);
+    const char* categoryCol = lengthCol + count * sizeof(uint32_t);
+    const char* statusCol = categoryCol + count * sizeof(uint8_t);
+    const char* heap = statusCol + count * sizeof(uint8_t);
+
+    std::vector<Application> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t offset = getColumn<uint32_t>(offsetCol, i);
+        uint32_t length = getColumn<uint32_t>(lengthCol, i);
+        if (static_cast<size_t>(offset) + length > header.heapSize) {
+            error = "запись " + std::to_string(i + 1) + ": логин выходит за пределы кучи строк";
+            return false;
+        }
+        uint8_t category = getColumn<uint8_t>(categoryCol, i);
+        uint8_t status = getColumn<uint8_t>(statusCol, i);
+        if (category > static_cast<uint8_t>(ScholarshipCategory::Presidential) ||
+            status > static_cast<uint8_t>(ApplicationStatus::Rejected)) {
+            error = "запись " + std::to_string(i + 1) + ": неизвестная категория или статус";
+            return false;
+        }
+
+        result.push_back(Application::restore(
+            getColumn<int32_t>(idCol, i),
+            std::string(heap + offset, length),
+            getColumn<double>(gradeCol, i),
+            static_cast<ScholarshipCategory>(category),
+            static_cast<ApplicationStatus>(status)));
+    }
+
+    applications.swap(result);
+    return true;
+}
@@ -0,0 +1,32 @@
+#ifndef APPLICATIONSNAPSHOT_H
+#define APPLICATIONSNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include "Application.h"
+
+class ApplicationsSnapshot;
+
+// Двоичный колоночный снимок таблицы заявок.
+//
+// Формат (версия 1, порядок байт платформы):
+//   заголовок: "APPS", версия, число записей, размер кучи строк
+//   double   grade[count]
+//   int32    id[count]
+//   uint32   nameOffset[count]   смещение логина в куче строк
+//   uint32   nameLength[count]
+//   uint8    category[count]
+//   uint8    status[count]
+//   char     heap[heapSize]      логины подряд, без разделителей
+//
+// Загрузка - одно отображение файла в память и чтение колонок, без разбора текста.
+class ApplicationSnapshot {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    static bool save(const std::string& filename, const ApplicationsSnapshot& applications);
+    static bool load(const std::string& filename, std::vector<Application>& applications,
+        std::string& error);
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "BackgroundWriter.h"
+#include "Logger.h"
+#include <chrono>
+#include <algorithm>
+
+BackgroundWriter::BackgroundWriter(size_t capacity)
+    : capacity(capacity > 0 ? capacity : 1), lastSequence(0), doneSequence(0),
+    failedSequence(0), stopping(false) {
+    worker = std::thread([this]() { workerLoop(); });
+}
+
+BackgroundWriter::~BackgroundWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    // Поток завершается только после того, как очередь опустеет
+    workAvailable.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+uint64_t BackgroundWriter::submit(const std::string& key, Task task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    stats.submitted++;
+
+    if (!key.empty()) {
+        auto it = std::find_if(queue.begin(), queue.end(),
+            [&key](const Entry& entry) { return entry.key == key; });
+        if (it != queue.end()) {
+            queue.erase(it);
+            stats.coalesced++;
+        }
+    }
+
+    spaceAvailable.wait(lock, [this]() { return queue.size() < capacity; });
+
+    uint64_t sequence = ++lastSequence;
+    queue.push_back(Entry{ key, std::move(task), sequence });
+    stats.queueDepth = queue.size();
+    stats.maxQueueDepth = std::max(stats.maxQueueDepth, queue.size());
+    workAvailable.notify_one();
+    return sequence;
+}
+
+void BackgroundWriter::wait() {
+    auto start = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    // Заменённые задачи не выполняются, но их действие входит в более
+    // позднюю задачу с тем же ключом, поэтому достаточно дождаться номера
+    uint64_t target = lastSequence;
+    taskDone.wait(lock, [this, target]() { return doneSequence >= target; });
+
+    double elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    stats.lastFlushMs = elapsed;
+    stats.maxFlushMs = std::max(stats.maxFlushMs, elapsed);
+}
+
+bool BackgroundWriter::flush(uint64_t since) {
+    wait();
+    std::lock_guard<std::mutex> lock(mutex);
+    return failedSequence == 0 || failedSequence < since;
+}
+
+WriterMetrics BackgroundWriter::metrics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void BackgroundWriter::workerLoop() {
+    while (true) {
+        Entry entry;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+
+            entry = std::move(queue.front());
+            queue.pop_front();
+            stats.queueDepth = queue.size();
+        }
+        spaceAvailable.notify_one();
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = false;
+        try {
+            ok = entry.task();
+        }
+        catch (const std::exception& e) {
+            LOG_ERROR("BackgroundWriter", "Ошибка фоновой записи: " << e.what());
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            doneSequence = entry.sequence;
+            stats.completed++;
+            stats.lastWriteMs = elapsed;
+            stats.maxWriteMs = std::max(stats.maxWriteMs, elapsed);
+            if (!ok) {
+                stats.failed++;
+                failedSequence = entry.sequence;
+            }
+        }
+        taskDone.notify_all();
+    }
+}
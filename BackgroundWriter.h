@@ -0,0 +1,82 @@
+#ifndef BACKGROUNDWRITER_H
+#define BACKGROUNDWRITER_H
+
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+// Показатели фоновой записи
+struct WriterMetrics {
+    size_t queueDepth = 0;        // задач в очереди сейчас
+    size_t maxQueueDepth = 0;
+    uint64_t submitted = 0;
+    uint64_t coalesced = 0;       // задач, заменённых более новыми с тем же ключом
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    double lastWriteMs = 0.0;     // длительность последней задачи
+    double maxWriteMs = 0.0;
+    double lastFlushMs = 0.0;     // ожидание в последнем flush
+    double maxFlushMs = 0.0;
+};
+
+// Фоновый поток записи на диск с ограниченной очередью.
+// Задачи выполняются строго в порядке постановки. Ещё не начатая задача с
+// тем же ключом заменяется новой, и новая встаёт в конец очереди: так
+// несколько сохранений одного файла сливаются в одно, а порядок относительно
+// остальных задач не нарушается. При заполненной очереди submit ждёт.
+// Каждая задача получает номер; flush сообщает об ошибках начиная с номера,
+// который передал вызывающий, поэтому разные пользователи writer не
+// забирают друг у друга сведения об ошибках.
+class BackgroundWriter {
+public:
+    using Task = std::function<bool()>;   // false - запись не удалась
+
+private:
+    struct Entry {
+        std::string key;
+        Task task;
+        uint64_t sequence;
+    };
+
+    std::deque<Entry> queue;
+    size_t capacity;
+    uint64_t lastSequence;     // номер последней поставленной задачи
+    uint64_t doneSequence;     // номер последней выполненной задачи
+    uint64_t failedSequence;   // номер последней неудавшейся задачи, 0 - ошибок не было
+    bool stopping;
+    WriterMetrics stats;
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable spaceAvailable;
+    std::condition_variable taskDone;
+    std::thread worker;
+
+    void workerLoop();
+
+public:
+    explicit BackgroundWriter(size_t capacity = 256);
+    ~BackgroundWriter();
+
+    BackgroundWriter(const BackgroundWriter&) = delete;
+    BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+
+    // Возвращает номер задачи (с 1). Пустой ключ - задача не сливается с другими;
+    // заменённая задача выполняется в составе новой с большим номером
+    uint64_t submit(const std::string& key, Task task);
+    uint64_t submit(Task task) { return submit(std::string(), std::move(task)); }
+
+    // Дожидается выполнения всех задач, поставленных до вызова
+    void wait();
+    // То же, что wait; false, если не удалась задача с номером since или более
+    // поздняя (в том числе чужая - ответ может быть только осторожнее)
+    bool flush(uint64_t since);
+
+    WriterMetrics metrics() const;
+};
+
+#endif
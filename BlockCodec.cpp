@@ -0,0 +1,136 @@
+#include "BlockCodec.h"
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    const size_t MIN_MATCH = 4;
+    const size_t MAX_OFFSET = 65535;
+    const int HASH_BITS = 14;
+
+    uint32_t read32(const char* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t hashOf(uint32_t sequence) {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    void putLength(std::string& out, size_t length) {
+        while (length >= 255) {
+            out += static_cast<char>(255);
+            length -= 255;
+        }
+        out += static_cast<char>(length);
+    }
+
+    void putSequence(std::string& out, std::string_view literals, size_t offset, size_t matchLength) {
+        size_t literalLength = literals.size();
+        size_t matchCode = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+
+        unsigned char token = static_cast<unsigned char>(
+            ((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+        out += static_cast<char>(token);
+        if (literalLength >= 15) putLength(out, literalLength - 15);
+        out.append(literals.data(), literals.size());
+
+        if (matchLength == 0) return;
+        out += static_cast<char>(offset & 0xFF);
+        out += static_cast<char>(offset >> 8);
+        if (matchCode >= 15) putLength(out, matchCode - 15);
+    }
+
+    bool getLength(const unsigned char*& p, const unsigned char* end, size_t& length) {
+        unsigned char byte;
+        do {
+            if (p == end) return false;
+            byte = *p++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+}
+
+std::string BlockCodec::compress(std::string_view data) {
+    std::string out;
+    out.reserve(data.size() / 2 + 16);
+
+    // Последняя позиция каждого 4-байтового фрагмента по его хешу
+    std::vector<int64_t> table(size_t(1) << HASH_BITS, -1);
+    const char* base = data.data();
+    size_t size = data.size();
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (pos + MIN_MATCH <= size) {
+        uint32_t sequence = read32(base + pos);
+        int64_t& slot = table[hashOf(sequence)];
+        int64_t candidate = slot;
+        slot = static_cast<int64_t>(pos);
+
+        if (candidate < 0 || pos - static_cast<size_t>(candidate) > MAX_OFFSET ||
+            read32(base + candidate) != sequence) {
+            ++pos;
+            continue;
+        }
+
+        size_t match = static_cast<size_t>(candidate);
+        size_t length = MIN_MATCH;
+        while (pos + length < size && base[match + length] == base[pos + length]) {
+            ++length;
+        }
+
+        putSequence(out, data.substr(anchor, pos - anchor), pos - match, length);
+        pos += length;
+        anchor = pos;
+    }
+
+    if (anchor < size) {
+        putSequence(out, data.substr(anchor), 0, 0);
+    }
+    return out;
+}
+
+bool BlockCodec::decompress(std::string_view packed, size_t rawSize, std::string& out) {
+    out.clear();
+    // rawSize берётся из заголовка файла: память под заведомо невозможный
+    // размер не выделяется
+    if (rawSize > packed.size() * MAX_EXPANSION) return false;
+    out.reserve(rawSize);
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(packed.data());
+    const unsigned char* end = p + packed.size();
+
+    while (p < end) {
+        unsigned char token = *p++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !getLength(p, end, literalLength)) return false;
+        if (static_cast<size_t>(end - p) < literalLength || out.size() + literalLength > rawSize) {
+            return false;
+        }
+        out.append(reinterpret_cast<const char*>(p), literalLength);
+        p += literalLength;
+
+        if (p == end) break;   // последняя команда - только литералы
+
+        if (end - p < 2) return false;
+        size_t offset = p[0] | (static_cast<size_t>(p[1]) << 8);
+        p += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !getLength(p, end, matchLength)) return false;
+        matchLength += MIN_MATCH;
+
+        if (offset == 0 || offset > out.size() || out.size() + matchLength > rawSize) {
+            return false;
+        }
+        // Совпадение может перекрывать само себя, поэтому копия побайтная
+        size_t from = out.size() - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            out += out[from + i];
+        }
+    }
+    return out.size() == rawSize;
+}
@@ -0,0 +1,23 @@
+#ifndef BLOCKCODEC_H
+#define BLOCKCODEC_H
+
+#include <string>
+#include <string_view>
+
+// Простое LZ-сжатие блоков в духе LZ4, без внешних зависимостей.
+// Сжатый блок - последовательность команд: байт-маркер (старшие 4 бита -
+// длина литералов, младшие - длина совпадения минус 4), продолжение длин
+// байтами по 255, литералы, 2 байта смещения совпадения. Последняя команда
+// содержит только литералы. Размер исходного блока хранится снаружи.
+class BlockCodec {
+public:
+    static std::string compress(std::string_view data);
+    // Во сколько раз блок может увеличиться при распаковке: байт продолжения
+    // длины совпадения даёт не больше 255 байт
+    static constexpr size_t MAX_EXPANSION = 255;
+
+    // false, если блок повреждён или распаковывается не в rawSize байт
+    static bool decompress(std::string_view packed, size_t rawSize, std::string& out);
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include "FieldTokenizer.h"
+#include "Utils.h"
+
+FieldTokenizer::FieldTokenizer(std::string_view line, char delimiter)
+    : line(line), delimiter(delimiter), pos(0), fieldIndex(0), exhausted(false) {}
+
+bool FieldTokenizer::fail(const char* name, const std::string& reason) {
+    if (errorMessage.empty()) {
+        errorMessage = "поле " + std::to_string(fieldIndex) + " (" + name + "): " + reason;
+    }
+    return false;
+}
+
+bool FieldTokenizer::next(std::string_view& field, const char* name) {
+    if (exhausted) {
+        ++fieldIndex;
+        return fail(name, "отсутствует");
+    }
+
+    ++fieldIndex;
+    size_t end = line.find(delimiter, pos);
+    if (end == std::string_view::npos) {
+        field = line.substr(pos);
+        exhausted = true;
+    }
+    else {
+        field = line.substr(pos, end - pos);
+        pos = end + 1;
+    }
+    return true;
+}
+
+bool FieldTokenizer::nextString(std::string& value, const char* name) {
+    std::string_view field;
+    if (!next(field, name)) return false;
+    value.assign(field);
+    return true;
+}
+
+bool FieldTokenizer::nextInt(int& value, const char* name) {
+    std::string_view field;
+    if (!next(field, name)) return false;
+    if (!Utils::parseInt(field, value)) {
+        return fail(name, "ожидалось целое число, получено '" + std::string(field) + "'");
+    }
+    return true;
+}
+
+bool FieldTokenizer::nextIntInRange(int& value, int low, int high, const char* name) {
+    if (!nextInt(value, name)) return false;
+    if (value < low || value >= high) {
+        return fail(name, "значение " + std::to_string(value) + " вне диапазона [" +
+            std::to_string(low) + ", " + std::to_string(high) + ")");
+    }
+    return true;
+}
+
+bool FieldTokenizer::nextInt64(long long& value, const char* name) {
+    std::string_view field;
+    if (!next(field, name)) return false;
+    if (!Utils::parseInt64(field, value)) {
+        return fail(name, "ожидалось целое число, получено '" + std::string(field) + "'");
+    }
+    return true;
+}
+
+bool FieldTokenizer::nextDouble(double& value, const char* name) {
+    std::string_view field;
+    if (!next(field, name)) return false;
+    if (!Utils::parseDouble(field, value)) {
+        return fail(name, "ожидалось число, получено '" + std::string(field) + "'");
+    }
+    return true;
+}
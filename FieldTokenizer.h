@@ -0,0 +1,35 @@
+#ifndef FIELDTOKENIZER_H
+#define FIELDTOKENIZER_H
+
+#include <string>
+#include <string_view>
+
+// Последовательный разбор полей строки с разделителем.
+// Поля - string_view в исходную строку, числа читаются через std::from_chars;
+// память выделяется только для текста ошибки.
+class FieldTokenizer {
+    std::string_view line;
+    char delimiter;
+    size_t pos;
+    int fieldIndex;
+    bool exhausted;
+    std::string errorMessage;
+
+    bool fail(const char* name, const std::string& reason);
+
+public:
+    FieldTokenizer(std::string_view line, char delimiter);
+
+    bool next(std::string_view& field, const char* name);
+    bool nextString(std::string& value, const char* name);
+    bool nextInt(int& value, const char* name);
+    // Целое из [low, high) - например, номер значения перечисления
+    bool nextIntInRange(int& value, int low, int high, const char* name);
+    bool nextInt64(long long& value, const char* name);
+    bool nextDouble(double& value, const char* name);
+
+    bool atEnd() const { return exhausted; }
+    const std::string& error() const { return errorMessage; }
+};
+
+#endif
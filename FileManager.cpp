@@ -1,22 +1,265 @@
 #include "FileManager.h"
+#include "Logger.h"
 #include <fstream>
-#include <iostream>
 #include <filesystem>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace {
+    // Запись буфера в файл (дозапись или перезапись) с необязательным fsync
+    bool writeRaw(const std::string& filename, std::string_view data, bool append, bool sync) {
+#ifdef _WIN32
+        int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (append ? _O_APPEND : _O_TRUNC);
+        int fd = -1;
+        if (_sopen_s(&fd, filename.c_str(), flags, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0) {
+            return false;
+        }
+#else
+        int flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+        int fd = ::open(filename.c_str(), flags, 0644);
+        if (fd < 0) return false;
+#endif
+        const char* p = data.data();
+        size_t left = data.size();
+        bool ok = true;
+        while (left > 0) {
+            const unsigned int chunk = left > (1u << 30) ? (1u << 30) : static_cast<unsigned int>(left);
+#ifdef _WIN32
+            int n = _write(fd, p, chunk);
+#else
+            ssize_t n = ::write(fd, p, chunk);
+#endif
+            if (n <= 0) { ok = false; break; }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+#ifdef _WIN32
+        if (ok && sync) ok = _commit(fd) == 0;
+        if (_close(fd) != 0) ok = false;
+#else
+        if (ok && sync) ok = ::fsync(fd) == 0;
+        if (::close(fd) != 0) ok = false;
+#endif
+        return ok;
+    }
+
+    // Атомарная замена target файлом source из того же каталога
+    bool replaceFile(const std::string& source, const std::string& target) {
+#ifdef _WIN32
+        return MoveFileExA(source.c_str(), target.c_str(),
+            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        if (::rename(source.c_str(), target.c_str()) != 0) return false;
+        // Сбрасываем на диск и саму запись каталога о переименовании
+        std::filesystem::path dir = std::filesystem::path(target).parent_path();
+        int dfd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+        if (dfd >= 0) {
+            ::fsync(dfd);
+            ::close(dfd);
+        }
+        return true;
+#endif
+    }
+}
+
+MappedFile::MappedFile(const std::string& filename) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(filename, ec);
+    if (ec) {
+        return;
+    }
+    if (size == 0) {
+        opened = true;   // пустой файл не отображается, но читается как пустой
+        return;
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    ptr = static_cast<const char*>(view);
+    length = static_cast<size_t>(size);
+    opened = true;
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    void* view = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return;
+    }
+    ::madvise(view, static_cast<size_t>(size), MADV_SEQUENTIAL);
+    ptr = static_cast<const char*>(view);
+    length = static_cast<size_t>(size);
+    opened = true;
+#endif
+}
+
+void MappedFile::close() {
+    if (ptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(ptr);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+        mappingHandle = nullptr;
+#else
+        ::munmap(const_cast<char*>(ptr), length);
+#endif
+    }
+    ptr = nullptr;
+    length = 0;
+    opened = false;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : ptr(other.ptr), length(other.length), opened(other.opened) {
+#ifdef _WIN32
+    fileHandle = other.fileHandle;
+    mappingHandle = other.mappingHandle;
+    other.fileHandle = nullptr;
+    other.mappingHandle = nullptr;
+#endif
+    other.ptr = nullptr;
+    other.length = 0;
+    other.opened = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        ptr = other.ptr;
+        length = other.length;
+        opened = other.opened;
+#ifdef _WIN32
+        fileHandle = other.fileHandle;
+        mappingHandle = other.mappingHandle;
+        other.fileHandle = nullptr;
+        other.mappingHandle = nullptr;
+#endif
+        other.ptr = nullptr;
+        other.length = 0;
+        other.opened = false;
+    }
+    return *this;
+}
+
+namespace {
+    // Обход строк буфера: '\r' в конце отбрасывается, пустые строки пропускаются
+    template <typename Callback>
+    void scanLines(std::string_view data, Callback&& callback) {
+        size_t start = 0;
+        size_t lineNumber = 0;
+        while (start < data.size()) {
+            size_t pos = data.find('\n', start);
+            if (pos == std::string_view::npos) pos = data.size();
+
+            std::string_view line = data.substr(start, pos - start);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            ++lineNumber;
+            if (!line.empty()) {
+                callback(line, lineNumber);
+            }
+            start = pos + 1;
+        }
+    }
+}
+
+MappedLines FileManager::mapLines(const std::string& filename) {
+    MappedLines result;
+    if (!std::filesystem::exists(filename)) {
+        LOG_DEBUG("FileManager", "Файл " << filename << " не найден. Будет создан новый");
+        return result;
+    }
+
+    result.file = MappedFile(filename);
+    if (!result.file.isOpen()) {
+        LOG_ERROR("FileManager", "Не удалось открыть файл " << filename);
+        return result;
+    }
+
+    scanLines(result.file.data(), [&result](std::string_view line, size_t) {
+        result.lines.push_back(line);
+        });
+    return result;
+}
+
+bool FileManager::forEachLine(const std::string& filename, const LineCallback& callback) {
+    if (!std::filesystem::exists(filename)) {
+        LOG_DEBUG("FileManager", "Файл " << filename << " не найден. Будет создан новый");
+        return false;
+    }
+
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        LOG_ERROR("FileManager", "Не удалось открыть файл " << filename);
+        return false;
+    }
+
+    scanLines(file.data(), callback);
+    return true;
+}
+
+void FileManager::splitFields(std::string_view line, char delimiter, std::vector<std::string_view>& out) {
+    out.clear();
+    size_t start = 0;
+    while (true) {
+        size_t pos = line.find(delimiter, start);
+        if (pos == std::string_view::npos) {
+            // Как и std::getline, не порождаем пустое поле после завершающего разделителя
+            if (start < line.size()) out.push_back(line.substr(start));
+            break;
+        }
+        out.push_back(line.substr(start, pos - start));
+        start = pos + 1;
+    }
+}
+
 std::vector<std::string> FileManager::readLines(const std::string& filename) {
     std::vector<std::string> lines;
 
     try {
-        //   
+        // Проверка существования файла
         std::filesystem::path filepath(filename);
         if (!std::filesystem::exists(filepath)) {
-            std::cout << ":  " << filename << "  .   .\n";
+            LOG_DEBUG("FileManager", "Файл " << filename << " не найден. Будет создан новый");
             return lines;
         }
 
         std::ifstream file(filename);
         if (!file.is_open()) {
-            std::cout << " FileManager:     " << filename << std::endl;
+            LOG_ERROR("FileManager", "Не удалось открыть файл " << filename);
             return lines;
         }
 
@@ -32,28 +275,115 @@ std::vector<std::string> FileManager::readLines(const std::string& filename) {
         file.close();
     }
     catch (const std::exception& e) {
-        std::cout << "    " << filename << ": " << e.what() << std::endl;
+        LOG_ERROR("FileManager", "Ошибка при чтении файла " << filename << ": " << e.what());
     }
     return lines;
 }
 
-void FileManager::writeLines(const std::string& filename, const std::vector<std::string>& lines) {
+bool FileManager::writeLines(const std::string& filename, const std::vector<std::string>& lines) {
+    // Всё содержимое собирается в один буфер и пишется одним вызовом
+    size_t total = 0;
+    for (const auto& line : lines) {
+        total += line.size() + 1;
+    }
+    std::string data;
+    data.reserve(total);
+    for (const auto& line : lines) {
+        data += line;
+        data += '\n';
+    }
+    return writeData(filename, data);
+}
+
+bool FileManager::writeData(const std::string& filename, std::string_view data) {
     try {
         std::filesystem::path filepath(filename);
         if (filepath.has_parent_path()) {
             std::filesystem::create_directories(filepath.parent_path());
         }
-        std::ofstream file(filename, std::ios::trunc);
-        if (!file.is_open()) {
-            std::cout << " FileManager:       " << filename << std::endl;
-            return;
+
+        // Пишем во временный файл рядом с целевым, fsync и переименование:
+        // при сбое на диске остаётся либо старая, либо новая версия файла
+        std::string tempFile = filename + ".tmp";
+        if (!writeRaw(tempFile, data, false, true)) {
+            LOG_ERROR("FileManager", "Не удалось открыть файл для записи " << filename);
+            removeFile(tempFile);
+            return false;
+        }
+        if (!replaceFile(tempFile, filename)) {
+            LOG_ERROR("FileManager", "Не удалось заменить файл " << filename);
+            removeFile(tempFile);
+            return false;
+        }
+        return true;
+    }
+    catch (const std::exception& e) {
+        LOG_ERROR("FileManager", "Ошибка при записи файла " << filename << ": " << e.what());
+    }
+    return false;
+}
+
+bool FileManager::appendLines(const std::string& filename, const std::vector<std::string>& lines, bool sync) {
+    if (lines.empty()) return true;
+
+    std::string data;
+    for (const auto& line : lines) {
+        data += line;
+        data += '\n';
+    }
+
+    if (!writeRaw(filename, data, true, sync)) {
+        LOG_ERROR("FileManager", "Не удалось дописать в файл " << filename);
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> FileManager::readJournal(const std::string& filename) {
+    std::vector<std::string> lines;
+
+    try {
+        std::filesystem::path filepath(filename);
+        if (!std::filesystem::exists(filepath)) {
+            return lines;
         }
-        for (const auto& line : lines) {
-            file << line << "\n";
+
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            LOG_ERROR("FileManager", "Не удалось открыть журнал " << filename);
+            return lines;
         }
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
         file.close();
+
+        size_t start = 0;
+        size_t pos;
+        while ((pos = data.find('\n', start)) != std::string::npos) {
+            std::string line = data.substr(start, pos - start);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty()) {
+                lines.push_back(line);
+            }
+            start = pos + 1;
+        }
+
+        // Запись, прерванная сбоем, не имеет завершающего перевода строки
+        if (start < data.size()) {
+            LOG_WARN("FileManager", "В журнале " << filename
+                << " найдена неполная запись, она будет отброшена");
+            std::filesystem::resize_file(filepath, start);
+        }
     }
     catch (const std::exception& e) {
-        std::cout << "    " << filename << ": " << e.what() << std::endl;
+        LOG_ERROR("FileManager", "Ошибка при чтении журнала " << filename << ": " << e.what());
     }
+    return lines;
+}
+
+bool FileManager::removeFile(const std::string& filename) {
+    std::error_code ec;
+    std::filesystem::remove(filename, ec);
+    return !ec;
 }
\ No newline at end of file
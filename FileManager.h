@@ -2,12 +2,81 @@
 #define FILEMANAGER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <functional>
+
+// Политика сброса журнала на диск
+enum class SyncPolicy {
+    None,       // данные остаются в буфере ОС
+    Periodic,   // fsync после каждых N записей
+    Always      // fsync после каждой записи
+};
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+    const char* ptr = nullptr;
+    size_t length = 0;
+    bool opened = false;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    void close();
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool isOpen() const { return opened; }
+    std::string_view data() const { return std::string_view(ptr, length); }
+};
+
+// Строки отображённого файла; string_view действительны, пока жив объект
+class MappedLines {
+    MappedFile file;
+    std::vector<std::string_view> lines;
+
+    friend class FileManager;
+
+public:
+    const std::vector<std::string_view>& getLines() const { return lines; }
+    size_t size() const { return lines.size(); }
+    bool empty() const { return lines.empty(); }
+    std::vector<std::string_view>::const_iterator begin() const { return lines.begin(); }
+    std::vector<std::string_view>::const_iterator end() const { return lines.end(); }
+};
 
 class FileManager {
 public:
+    using LineCallback = std::function<void(std::string_view line, size_t lineNumber)>;
+
     static std::vector<std::string> readLines(const std::string& filename);
-    static void writeLines(const std::string& filename, const std::vector<std::string>& lines);
+
+    // Чтение без копирования строк: файл отображается в память, '\r' в конце
+    // строки отбрасывается, пустые строки пропускаются
+    static MappedLines mapLines(const std::string& filename);
+    // Потоковый вариант: callback вызывается для каждой непустой строки
+    // (номер строки считается с 1)
+    static bool forEachLine(const std::string& filename, const LineCallback& callback);
+    // Разбиение строки на поля; out переиспользуется между вызовами
+    static void splitFields(std::string_view line, char delimiter, std::vector<std::string_view>& out);
+    static bool writeLines(const std::string& filename, const std::vector<std::string>& lines);
+    // Атомарная запись произвольного содержимого (временный файл + переименование)
+    static bool writeData(const std::string& filename, std::string_view data);
+
+    // Журнальный режим: дозапись строк в конец файла
+    static bool appendLines(const std::string& filename, const std::vector<std::string>& lines, bool sync);
+    // Чтение журнала; оборванная последняя строка отбрасывается и отрезается от файла
+    static std::vector<std::string> readJournal(const std::string& filename);
+    static bool removeFile(const std::string& filename);
 };
 
-#endif 
\ No newline at end of file
+#endif 
@@ -0,0 +1,291 @@
+#include "HistoryArchive.h"
+#include "BlockCodec.h"
+#include "FileManager.h"
+#include "Logger.h"
+#include <cstdint>
+#include <algorithm>
+
+namespace {
+    const char ARCHIVE_MAGIC[4] = { 'H', 'A', 'R', 'C' };
+    const uint32_t ARCHIVE_VERSION = 1;
+    const size_t INDEX_ENTRY_SIZE = 8 + 4 + 4 + 4 + 8 + 8;
+    // Запись занимает в блоке не меньше байта в каждом из семи столбцов
+    const size_t MIN_RECORD_SIZE = 7;
+
+    // Оглавление: положение и границы времени блока
+    struct BlockInfo {
+        uint64_t offset = 0;
+        uint32_t packedSize = 0;
+        uint32_t rawSize = 0;
+        uint32_t count = 0;
+        int64_t minTime = 0;
+        int64_t maxTime = 0;
+    };
+
+    // Числа записываются в порядке little-endian независимо от платформы
+    void put32(std::string& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+
+    void put64(std::string& out, uint64_t value) {
+        for (int i = 0; i < 8; ++i) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+
+    void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Последовательное чтение с проверкой границ
+    class Reader {
+        const unsigned char* p;
+        const unsigned char* end;
+
+    public:
+        explicit Reader(std::string_view data)
+            : p(reinterpret_cast<const unsigned char*>(data.data())), end(p + data.size()) {}
+
+        bool get32(uint32_t& value) {
+            if (end - p < 4) return false;
+            value = 0;
+            for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(p[i]) << (8 * i);
+            p += 4;
+            return true;
+        }
+
+        bool get64(uint64_t& value) {
+            if (end - p < 8) return false;
+            value = 0;
+            for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(p[i]) << (8 * i);
+            p += 8;
+            return true;
+        }
+
+        bool getVarint(uint64_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (p == end) return false;
+                unsigned char byte = *p++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool getBytes(size_t length, std::string_view& value) {
+            if (static_cast<size_t>(end - p) < length) return false;
+            value = std::string_view(reinterpret_cast<const char*>(p), length);
+            p += length;
+            return true;
+        }
+    };
+
+    // Столбцы блока: ID заявки (разность с предыдущим), студент, стипендия,
+    // действие, администратор, комментарий (номера словаря), время
+    std::string encodeBlock(const HistoryRecord* first, const HistoryRecord* last,
+        std::vector<uint32_t>& localIds, std::vector<uint32_t>& dictionary) {
+        auto localId = [&](uint32_t id) {
+            if (localIds[id] == UINT32_MAX) {
+                dictionary.push_back(id);
+                localIds[id] = static_cast<uint32_t>(dictionary.size());
+            }
+            return localIds[id];
+        };
+
+        std::string raw;
+        int64_t previousId = 0;
+        for (const HistoryRecord* it = first; it != last; ++it) {
+            putVarint(raw, zigzag(it->applicationId - previousId));
+            previousId = it->applicationId;
+        }
+        for (const HistoryRecord* it = first; it != last; ++it) putVarint(raw, localId(it->studentId));
+        for (const HistoryRecord* it = first; it != last; ++it) putVarint(raw, localId(it->scholarshipTypeId));
+        for (const HistoryRecord* it = first; it != last; ++it) putVarint(raw, static_cast<uint64_t>(it->action));
+        for (const HistoryRecord* it = first; it != last; ++it) putVarint(raw, localId(it->adminId));
+        for (const HistoryRecord* it = first; it != last; ++it) putVarint(raw, localId(it->commentId));
+        int64_t previousTime = static_cast<int64_t>(first->timestamp);
+        for (const HistoryRecord* it = first; it != last; ++it) {
+            putVarint(raw, zigzag(static_cast<int64_t>(it->timestamp) - previousTime));
+            previousTime = static_cast<int64_t>(it->timestamp);
+        }
+        return raw;
+    }
+
+    bool decodeBlock(std::string_view raw, const BlockInfo& info,
+        const std::vector<uint32_t>& symbols, std::vector<HistoryRecord>& out) {
+        // Число записей из оглавления проверяется до выделения памяти
+        if (info.count == 0 || info.count > HistoryArchive::BLOCK_RECORDS ||
+            info.count > raw.size() / MIN_RECORD_SIZE) {
+            return false;
+        }
+
+        Reader reader(raw);
+        size_t start = out.size();
+        out.resize(start + info.count);
+        HistoryRecord* block = out.data() + start;
+
+        uint64_t value;
+        int64_t previousId = 0;
+        for (uint32_t i = 0; i < info.count; ++i) {
+            if (!reader.getVarint(value)) return false;
+            previousId += unzigzag(value);
+            block[i].applicationId = static_cast<int>(previousId);
+        }
+
+        for (auto column : { &HistoryRecord::studentId, &HistoryRecord::scholarshipTypeId }) {
+            for (uint32_t i = 0; i < info.count; ++i) {
+                if (!reader.getVarint(value) || value >= symbols.size()) return false;
+                block[i].*column = symbols[value];
+            }
+        }
+        for (uint32_t i = 0; i < info.count; ++i) {
+            if (!reader.getVarint(value) || value >= HISTORY_ACTION_COUNT) return false;
+            block[i].action = static_cast<HistoryAction>(value);
+        }
+        for (auto column : { &HistoryRecord::adminId, &HistoryRecord::commentId }) {
+            for (uint32_t i = 0; i < info.count; ++i) {
+                if (!reader.getVarint(value) || value >= symbols.size()) return false;
+                block[i].*column = symbols[value];
+            }
+        }
+        int64_t previousTime = info.minTime;
+        for (uint32_t i = 0; i < info.count; ++i) {
+            if (!reader.getVarint(value)) return false;
+            previousTime += unzigzag(value);
+            block[i].timestamp = static_cast<std::time_t>(previousTime);
+        }
+        return true;
+    }
+}
+
+bool HistoryArchive::write(const std::string& filename,
+    const HistoryRecord* first, const HistoryRecord* last) {
+    // Словарь файла содержит только встречающиеся строки, нумерация с 1
+    std::vector<uint32_t> localIds(HistoryRecord::symbolCount(), UINT32_MAX);
+    std::vector<uint32_t> dictionary;
+    localIds[0] = 0;
+
+    std::vector<BlockInfo> blocks;
+    std::vector<std::string> packed;
+    for (const HistoryRecord* block = first; block != last; ) {
+        size_t count = std::min(BLOCK_RECORDS, static_cast<size_t>(last - block));
+        const HistoryRecord* blockEnd = block + count;
+
+        std::string raw = encodeBlock(block, blockEnd, localIds, dictionary);
+        BlockInfo info;
+        info.rawSize = static_cast<uint32_t>(raw.size());
+        info.count = static_cast<uint32_t>(count);
+        info.minTime = static_cast<int64_t>(block->timestamp);
+        info.maxTime = static_cast<int64_t>((blockEnd - 1)->timestamp);
+        packed.push_back(BlockCodec::compress(raw));
+        info.packedSize = static_cast<uint32_t>(packed.back().size());
+        blocks.push_back(info);
+        block = blockEnd;
+    }
+
+    std::string header(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    put32(header, ARCHIVE_VERSION);
+    put32(header, static_cast<uint32_t>(dictionary.size()));
+    for (uint32_t id : dictionary) {
+        const std::string& s = HistoryRecord::symbol(id);
+        putVarint(header, s.size());
+        header += s;
+    }
+    put32(header, static_cast<uint32_t>(blocks.size()));
+
+    uint64_t offset = header.size() + blocks.size() * INDEX_ENTRY_SIZE;
+    for (auto& info : blocks) {
+        info.offset = offset;
+        offset += info.packedSize;
+        put64(header, info.offset);
+        put32(header, info.packedSize);
+        put32(header, info.rawSize);
+        put32(header, info.count);
+        put64(header, static_cast<uint64_t>(info.minTime));
+        put64(header, static_cast<uint64_t>(info.maxTime));
+    }
+
+    std::string data;
+    data.reserve(static_cast<size_t>(offset));
+    data += header;
+    for (const auto& block : packed) data += block;
+    return FileManager::writeData(filename, data);
+}
+
+bool HistoryArchive::read(const std::string& filename, std::time_t from, std::time_t to,
+    std::vector<HistoryRecord>& out) {
+    MappedFile file(filename);
+    if (!file.isOpen()) return false;
+
+    std::string_view data = file.data();
+    Reader reader(data);
+    std::string_view magic;
+    uint32_t version, dictionarySize, blockCount;
+    if (!reader.getBytes(sizeof(ARCHIVE_MAGIC), magic) ||
+        magic != std::string_view(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) ||
+        !reader.get32(version) || version != ARCHIVE_VERSION ||
+        !reader.get32(dictionarySize)) {
+        LOG_ERROR("HistoryArchive", filename << " не является архивом истории");
+        return false;
+    }
+
+    // Локальный номер -> идентификатор общего словаря, 0 - пустая строка.
+    // Строка словаря занимает не меньше байта длины
+    if (dictionarySize > data.size()) {
+        LOG_ERROR("HistoryArchive", "Повреждён словарь архива " << filename);
+        return false;
+    }
+    std::vector<uint32_t> symbols(1, 0);
+    symbols.reserve(static_cast<size_t>(dictionarySize) + 1);
+    for (uint32_t i = 0; i < dictionarySize; ++i) {
+        uint64_t length;
+        std::string_view s;
+        if (!reader.getVarint(length) || !reader.getBytes(static_cast<size_t>(length), s)) {
+            LOG_ERROR("HistoryArchive", "Повреждён словарь архива " << filename);
+            return false;
+        }
+        symbols.push_back(HistoryRecord::intern(s));
+    }
+
+    if (!reader.get32(blockCount)) return false;
+    bool all = from == 0 && to == 0;
+    std::string raw;
+    for (uint32_t b = 0; b < blockCount; ++b) {
+        BlockInfo info;
+        uint64_t minTime, maxTime;
+        if (!reader.get64(info.offset) || !reader.get32(info.packedSize) ||
+            !reader.get32(info.rawSize) || !reader.get32(info.count) ||
+            !reader.get64(minTime) || !reader.get64(maxTime)) {
+            LOG_ERROR("HistoryArchive", "Повреждено оглавление архива " << filename);
+            return false;
+        }
+        info.minTime = static_cast<int64_t>(minTime);
+        info.maxTime = static_cast<int64_t>(maxTime);
+
+        // Блок вне периода не распаковывается
+        if (!all && (info.maxTime < static_cast<int64_t>(from) || info.minTime > static_cast<int64_t>(to))) {
+            continue;
+        }
+
+        size_t start = out.size();
+        if (info.offset > data.size() || info.packedSize > data.size() - info.offset ||
+            !BlockCodec::decompress(data.substr(static_cast<size_t>(info.offset), info.packedSize), info.rawSize, raw) ||
+            !decodeBlock(raw, info, symbols, out)) {
+            out.resize(start);
+            LOG_WARN("HistoryArchive", "Повреждён блок " << (b + 1) << " архива " << filename
+                << ", блок пропущен");
+        }
+    }
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef HISTORYARCHIVE_H
+#define HISTORYARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include "ApplicationHistory.h"
+
+// Архивный формат закрытых сегментов истории: словарь строк сегмента и
+// блоки по BLOCK_RECORDS записей, сжатые BlockCodec. Внутри блока записи
+// разложены по столбцам переменной длины (время - разность с предыдущей
+// записью), что хорошо сжимается. В оглавлении для каждого блока хранятся
+// наименьшее и наибольшее время, поэтому выборка по периоду распаковывает
+// только пересекающиеся с ним блоки.
+class HistoryArchive {
+public:
+    static constexpr size_t BLOCK_RECORDS = 4096;
+
+    // Записи [first, last) должны идти по времени
+    static bool write(const std::string& filename,
+        const HistoryRecord* first, const HistoryRecord* last);
+
+    // Дописывает в out записи блоков, пересекающихся с [from, to];
+    // при from = to = 0 читаются все блоки. Записи на краях блоков могут
+    // выходить за период - точную границу проверяет вызывающий.
+    static bool read(const std::string& filename, std::time_t from, std::time_t to,
+        std::vector<HistoryRecord>& out);
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "HistoryExporter.h"
+#include "Utils.h"
+#include <fstream>
+#include <stdexcept>
+#include <ctime>
+
+namespace {
+    const size_t EXPORT_PAGE_SIZE = 4096;          // записей за один запрос
+    const size_t EXPORT_BUFFER_SIZE = 1 << 20;     // байт до сброса в файл
+
+    // Накопитель вывода: одна запись в файл на каждый заполненный блок
+    class ExportBuffer {
+        std::ofstream& file;
+        std::string data;
+
+    public:
+        explicit ExportBuffer(std::ofstream& f) : file(f) {
+            data.reserve(EXPORT_BUFFER_SIZE + 4096);
+        }
+
+        std::string& text() { return data; }
+
+        void flushIfFull() {
+            if (data.size() >= EXPORT_BUFFER_SIZE) flush();
+        }
+
+        void flush() {
+            if (data.empty()) return;
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!file) throw std::runtime_error("Ошибка записи в файл экспорта!");
+            data.clear();
+        }
+    };
+
+    std::string formatTime(std::time_t timestamp, const char* pattern) {
+        char timeStr[32];
+        struct tm timeinfo;
+        localtime_s(&timeinfo, &timestamp);
+        strftime(timeStr, sizeof(timeStr), pattern, &timeinfo);
+        return timeStr;
+    }
+
+    void writeHeader(std::string& out, ExportFormat format) {
+        switch (format) {
+        case ExportFormat::Text:
+            out += "ЭКСПОРТ ИСТОРИИ ЗАЯВОК НА СТИПЕНДИИ\n";
+            out += "Дата экспорта: ";
+            out += formatTime(std::time(nullptr), "%d.%m.%Y %H:%M:%S");
+            out += "\n========================================\n\n";
+            break;
+        case ExportFormat::Csv:
+            out += "id,student,scholarship,action,admin,time,comment\n";
+            break;
+        case ExportFormat::JsonLines:
+            break;
+        }
+    }
+
+    void writeRecord(std::string& out, ExportFormat format, const HistoryRecord& record) {
+        switch (format) {
+        case ExportFormat::Text:
+            out += record.toString();
+            out += "\n----------------------------------------\n";
+            break;
+
+        case ExportFormat::Csv:
+            out += std::to_string(record.applicationId);
+            out += ',';
+            out += Utils::escapeCSV(record.getStudentUsername());
+            out += ',';
+            out += Utils::escapeCSV(record.getScholarshipType());
+            out += ',';
+            out += Utils::escapeCSV(record.actionToString());
+            out += ',';
+            out += Utils::escapeCSV(record.getAdminUsername());
+            out += ',';
+            out += formatTime(record.timestamp, "%Y-%m-%d %H:%M:%S");
+            out += ',';
+            out += Utils::escapeCSV(record.getComment());
+            out += '\n';
+            break;
+
+        case ExportFormat::JsonLines:
+            out += "{\"id\":";
+            out += std::to_string(record.applicationId);
+            out += ",\"student\":";
+            out += Utils::escapeJSON(record.getStudentUsername());
+            out += ",\"scholarship\":";
+            out += Utils::escapeJSON(record.getScholarshipType());
+            out += ",\"action\":";
+            out += Utils::escapeJSON(record.actionToString());
+            out += ",\"admin\":";
+            out += Utils::escapeJSON(record.getAdminUsername());
+            out += ",\"timestamp\":";
+            out += std::to_string(static_cast<long long>(record.timestamp));
+            out += ",\"time\":\"";
+            out += formatTime(record.timestamp, "%Y-%m-%dT%H:%M:%S");
+            out += "\",\"comment\":";
+            out += Utils::escapeJSON(record.getComment());
+            out += "}\n";
+            break;
+        }
+    }
+}
+
+size_t HistoryExporter::exportToFile(const ApplicationHistory& history, const std::string& filename,
+    ExportFormat format, const HistoryFilter& filter) {
+    // Текстовый отчёт - с переводами строк платформы, как прежде;
+    // CSV и JSON Lines пишутся в двоичном режиме и не зависят от платформы
+    std::ios::openmode mode = std::ios::out | std::ios::trunc;
+    if (format != ExportFormat::Text) mode |= std::ios::binary;
+    std::ofstream file(filename, mode);
+    if (!file.is_open()) {
+        throw std::runtime_error("Не удалось создать файл!");
+    }
+
+    ExportBuffer buffer(file);
+    writeHeader(buffer.text(), format);
+
+    size_t exported = 0;
+    HistoryCursor cursor;
+    while (true) {
+        HistoryPage page = history.query(filter).oldestFirst().after(cursor).limit(EXPORT_PAGE_SIZE).fetch();
+        for (const auto& record : page.records) {
+            writeRecord(buffer.text(), format, record);
+            buffer.flushIfFull();
+        }
+        exported += page.records.size();
+
+        if (!page.hasMore) break;
+        cursor = page.next;
+    }
+
+    if (format == ExportFormat::Text) {
+        buffer.text() += "\nИТОГО: " + std::to_string(exported) + " записей\n";
+    }
+    buffer.flush();
+
+    file.close();
+    if (file.fail()) {
+        throw std::runtime_error("Ошибка записи в файл экспорта!");
+    }
+    return exported;
+}
+
+std::string HistoryExporter::formatName(ExportFormat format) {
+    switch (format) {
+    case ExportFormat::Text: return "Текстовый отчёт";
+    case ExportFormat::Csv: return "CSV";
+    case ExportFormat::JsonLines: return "JSON Lines";
+    default: return "НЕИЗВЕСТНО";
+    }
+}
+
+std::string HistoryExporter::defaultExtension(ExportFormat format) {
+    switch (format) {
+    case ExportFormat::Csv: return ".csv";
+    case ExportFormat::JsonLines: return ".jsonl";
+    default: return ".txt";
+    }
+}
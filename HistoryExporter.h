@@ -0,0 +1,29 @@
+#ifndef HISTORYEXPORTER_H
+#define HISTORYEXPORTER_H
+
+#include <string>
+#include "ApplicationHistory.h"
+
+// Формат файла экспорта истории
+enum class ExportFormat {
+    Text,       // человекочитаемый отчёт, как на экране
+    Csv,        // заголовок и по строке на запись, поля через Utils::escapeCSV
+    JsonLines   // по объекту JSON в UTF-8 на строку
+};
+
+// Потоковый экспорт истории: записи читаются страницами через
+// ApplicationHistory::query (от старых к новым, как в прежнем отчёте) и сразу
+// сериализуются в буфер, который сбрасывается в файл крупными блоками.
+// Полная копия истории не создаётся.
+class HistoryExporter {
+public:
+    // Возвращает число выгруженных записей; при ошибке открытия или
+    // записи файла бросает std::runtime_error
+    static size_t exportToFile(const ApplicationHistory& history, const std::string& filename,
+        ExportFormat format, const HistoryFilter& filter = HistoryFilter());
+
+    static std::string formatName(ExportFormat format);
+    static std::string defaultExtension(ExportFormat format);
+};
+
+#endif
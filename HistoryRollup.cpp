@@ -0,0 +1,226 @@
+#include "HistoryRollup.h"
+#include "ApplicationHistory.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    // Число дней от 01.01.1970 до даты григорианского календаря
+    int daysFromCivil(int year, int month, int day) {
+        year -= month <= 2;
+        int era = (year >= 0 ? year : year - 399) / 400;
+        int yearOfEra = year - era * 400;
+        int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    void civilFromDays(int days, int& year, int& month, int& day) {
+        days += 719468;
+        int era = (days >= 0 ? days : days - 146096) / 146097;
+        int dayOfEra = days - era * 146097;
+        int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        int mp = (5 * dayOfYear + 2) / 153;
+        day = dayOfYear - (153 * mp + 2) / 5 + 1;
+        month = mp + (mp < 10 ? 3 : -9);
+        year = yearOfEra + era * 400 + (month <= 2);
+    }
+
+    std::string formatDate(int days) {
+        int year, month, day;
+        civilFromDays(days, year, month, day);
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%02d.%02d.%04d", day, month, year);
+        return buffer;
+    }
+
+    // Действие - старшие 4 бита ключа
+    const uint64_t TYPE_BITS = 28;
+    const uint64_t ADMIN_BITS = 32;
+}
+
+uint64_t HistoryRollup::makeKey(HistoryAction action, uint32_t type, uint32_t admin) {
+    return (static_cast<uint64_t>(action) << (TYPE_BITS + ADMIN_BITS)) |
+        (static_cast<uint64_t>(type) << ADMIN_BITS) |
+        static_cast<uint64_t>(admin);
+}
+
+int HistoryRollup::bucketOf(RollupGranularity granularity, std::time_t timestamp) {
+    struct tm timeinfo;
+    localtime_s(&timeinfo, &timestamp);
+    return bucketOf(granularity, timeinfo);
+}
+
+int HistoryRollup::bucketOf(RollupGranularity granularity, const struct tm& timeinfo) {
+    int year = timeinfo.tm_year + 1900;
+    int month = timeinfo.tm_mon + 1;
+    int days = daysFromCivil(year, month, timeinfo.tm_mday);
+
+    switch (granularity) {
+    case RollupGranularity::Week:
+        // 01.01.1970 - четверг; неделя начинается с понедельника
+        return (days + 3) >= 0 ? (days + 3) / 7 : (days + 3 - 6) / 7;
+    case RollupGranularity::Semester:
+        // Осенний семестр учебного года Y/Y+1 - 2Y+1, весенний семестр года Y - 2Y
+        if (month >= 9) return year * 2 + 1;
+        if (month == 1) return (year - 1) * 2 + 1;
+        return year * 2;
+    case RollupGranularity::Day:
+    default:
+        return days;
+    }
+}
+
+std::string HistoryRollup::bucketLabel(RollupGranularity granularity, int bucket) {
+    switch (granularity) {
+    case RollupGranularity::Week:
+        return "неделя с " + formatDate(bucket * 7 - 3);
+    case RollupGranularity::Semester: {
+        int year = bucket / 2;
+        if (bucket % 2 == 1) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "осень %d/%02d", year, (year + 1) % 100);
+            return buffer;
+        }
+        return "весна " + std::to_string(year);
+    }
+    case RollupGranularity::Day:
+    default:
+        return formatDate(bucket);
+    }
+}
+
+std::time_t HistoryRollup::bucketStart(RollupGranularity granularity, int bucket) {
+    int days;
+    switch (granularity) {
+    case RollupGranularity::Week:
+        days = bucket * 7 - 3;
+        break;
+    case RollupGranularity::Semester:
+        // Осенний семестр начинается 1 сентября, весенний - 1 февраля
+        days = daysFromCivil(bucket / 2, bucket % 2 == 1 ? 9 : 2, 1);
+        break;
+    case RollupGranularity::Day:
+    default:
+        days = bucket;
+        break;
+    }
+
+    struct tm timeinfo = {};
+    int year, month, day;
+    civilFromDays(days, year, month, day);
+    timeinfo.tm_year = year - 1900;
+    timeinfo.tm_mon = month - 1;
+    timeinfo.tm_mday = day;
+    timeinfo.tm_isdst = -1;
+    return std::mktime(&timeinfo);
+}
+
+HistoryRollup::Bucket& HistoryRollup::bucketFor(RollupGranularity granularity, int id) {
+    auto& list = buckets[static_cast<int>(granularity)];
+    // Записи приходят по порядку времени - обычно нужна последняя корзина
+    if (!list.empty() && list.back().id == id) return list.back();
+
+    auto it = std::lower_bound(list.begin(), list.end(), id,
+        [](const Bucket& bucket, int value) { return bucket.id < value; });
+    if (it != list.end() && it->id == id) return *it;
+    return *list.insert(it, Bucket{ id, {} });
+}
+
+void HistoryRollup::add(HistoryAction action, uint32_t scholarshipTypeId, uint32_t adminId,
+    std::time_t timestamp) {
+    uint64_t key = makeKey(action, scholarshipTypeId, adminId);
+
+    // Дата раскладывается один раз, все три корзины считаются из неё
+    struct tm timeinfo;
+    localtime_s(&timeinfo, &timestamp);
+
+    const RollupGranularity all[] = {
+        RollupGranularity::Day, RollupGranularity::Week, RollupGranularity::Semester
+    };
+    for (RollupGranularity granularity : all) {
+        bucketFor(granularity, bucketOf(granularity, timeinfo)).counts[key]++;
+    }
+}
+
+void HistoryRollup::clear() {
+    for (auto& list : buckets) {
+        list.clear();
+    }
+}
+
+std::string HistoryRollup::groupName(RollupGroup group, uint64_t key) const {
+    switch (group) {
+    case RollupGroup::Action:
+        return historyActionToString(static_cast<HistoryAction>(key >> (TYPE_BITS + ADMIN_BITS)));
+    case RollupGroup::ScholarshipType:
+        return HistoryRecord::symbol(static_cast<uint32_t>((key >> ADMIN_BITS) & ((1ull << TYPE_BITS) - 1)));
+    case RollupGroup::Admin: {
+        const std::string& admin = HistoryRecord::symbol(static_cast<uint32_t>(key & 0xFFFFFFFFull));
+        return admin.empty() ? "система" : admin;
+    }
+    case RollupGroup::None:
+    default:
+        return "";
+    }
+}
+
+std::vector<RollupRow> HistoryRollup::query(RollupGranularity granularity, std::time_t from,
+    std::time_t to, const RollupFilter& filter, RollupGroup group) const {
+    std::vector<RollupRow> rows;
+
+    // Ограничения фильтра переводятся в идентификаторы словарей один раз
+    uint32_t typeId = 0;
+    uint32_t adminId = 0;
+    if (!filter.scholarshipType.empty()) {
+        typeId = HistoryRecord::findSymbol(filter.scholarshipType);
+        if (typeId == StringDictionary::NOT_FOUND) return rows;
+    }
+    if (!filter.admin.empty()) {
+        adminId = HistoryRecord::findSymbol(filter.admin);
+        if (adminId == StringDictionary::NOT_FOUND) return rows;
+    }
+
+    const auto& list = buckets[static_cast<int>(granularity)];
+    int first = bucketOf(granularity, from);
+    int last = bucketOf(granularity, to);
+    auto it = std::lower_bound(list.begin(), list.end(), first,
+        [](const Bucket& bucket, int value) { return bucket.id < value; });
+
+    for (; it != list.end() && it->id <= last; ++it) {
+        std::vector<std::pair<std::string, int>> groups;
+        for (const auto& entry : it->counts) {
+            uint64_t key = entry.first;
+            if (filter.byAction &&
+                static_cast<HistoryAction>(key >> (TYPE_BITS + ADMIN_BITS)) != filter.action) continue;
+            if (!filter.scholarshipType.empty() &&
+                ((key >> ADMIN_BITS) & ((1ull << TYPE_BITS) - 1)) != typeId) continue;
+            if (!filter.admin.empty() && (key & 0xFFFFFFFFull) != adminId) continue;
+
+            std::string name = groupName(group, key);
+            auto found = std::find_if(groups.begin(), groups.end(),
+                [&name](const std::pair<std::string, int>& g) { return g.first == name; });
+            if (found == groups.end()) {
+                groups.emplace_back(name, entry.second);
+            }
+            else {
+                found->second += entry.second;
+            }
+        }
+
+        std::sort(groups.begin(), groups.end());
+        for (const auto& g : groups) {
+            rows.push_back(RollupRow{ it->id, bucketLabel(granularity, it->id), g.first, g.second });
+        }
+    }
+    return rows;
+}
+
+int HistoryRollup::total(RollupGranularity granularity, std::time_t from, std::time_t to,
+    const RollupFilter& filter) const {
+    int sum = 0;
+    for (const auto& row : query(granularity, from, to, filter)) {
+        sum += row.count;
+    }
+    return sum;
+}
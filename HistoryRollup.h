@@ -0,0 +1,79 @@
+#ifndef HISTORYROLLUP_H
+#define HISTORYROLLUP_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ctime>
+#include <cstdint>
+
+enum class HistoryAction;
+
+// Размер корзины агрегатов
+enum class RollupGranularity {
+    Day,
+    Week,       // с понедельника
+    Semester    // осенний: сентябрь - январь, весенний: февраль - август
+};
+
+// Измерение, по которому раскладываются счётчики внутри корзины
+enum class RollupGroup {
+    None,
+    Action,
+    ScholarshipType,
+    Admin
+};
+
+// Ограничения запроса; пустые поля не ограничивают выборку
+struct RollupFilter {
+    bool byAction = false;
+    HistoryAction action{};
+    std::string scholarshipType;
+    std::string admin;
+};
+
+struct RollupRow {
+    int bucket;          // номер корзины (см. HistoryRollup::bucketOf)
+    std::string label;   // "01.09.2024", "неделя с 02.09.2024", "осень 2024/25"
+    std::string group;   // значение измерения RollupGroup, пусто для None
+    int count;
+};
+
+// Агрегаты истории по времени: для каждой корзины каждой гранулярности
+// хранится число записей по ключу (действие, вид стипендии, администратор).
+// Запросы по диапазону дат суммируют корзины и не читают сами записи.
+class HistoryRollup {
+    struct Bucket {
+        int id;
+        std::unordered_map<uint64_t, int> counts;   // ключ - см. makeKey
+    };
+
+    std::vector<Bucket> buckets[3];   // по RollupGranularity, по возрастанию id
+
+    static uint64_t makeKey(HistoryAction action, uint32_t type, uint32_t admin);
+    Bucket& bucketFor(RollupGranularity granularity, int id);
+    std::string groupName(RollupGroup group, uint64_t key) const;
+
+public:
+    // Вид стипендии и администратор - идентификаторы общего словаря истории
+    // (HistoryRecord::intern), 0 - пустая строка
+    void add(HistoryAction action, uint32_t scholarshipTypeId, uint32_t adminId, std::time_t timestamp);
+    void clear();
+
+    // Номер корзины, в которую попадает момент времени (по местному времени)
+    static int bucketOf(RollupGranularity granularity, std::time_t timestamp);
+    static int bucketOf(RollupGranularity granularity, const struct tm& timeinfo);
+    static std::string bucketLabel(RollupGranularity granularity, int bucket);
+    // Полночь первого дня корзины по местному времени
+    static std::time_t bucketStart(RollupGranularity granularity, int bucket);
+
+    // Счётчики по корзинам, пересекающим [from, to]; корзины без записей пропускаются
+    std::vector<RollupRow> query(RollupGranularity granularity, std::time_t from, std::time_t to,
+        const RollupFilter& filter = RollupFilter(), RollupGroup group = RollupGroup::None) const;
+
+    // Сумма по тем же корзинам
+    int total(RollupGranularity granularity, std::time_t from, std::time_t to,
+        const RollupFilter& filter = RollupFilter()) const;
+};
+
+#endif
@@ -2,18 +2,48 @@
 #define IUSER_H
 
 #include <string>
+#include <string_view>
+#include <vector>
+
+// Роль пользователя - тег в самом объекте, проверяется без виртуального вызова
+enum class UserRole { Student, Admin };
 
 class IUser {
+    friend class UserManager;
+
+    // Список изменённых пользователей UserManager, в котором состоит объект
+    std::vector<IUser*>* dirtyList = nullptr;
+
+    void clearDirty() { dirty = false; }
+
 protected:
     std::string username;
     std::string passwordHash;
+    UserRole role;
+    // Запись изменилась после последнего сохранения; новый объект ещё не
+    // сохранён. При первом изменении объект встаёт в список dirtyList,
+    // после записи в файл UserManager сбрасывает флаг и список
+    bool dirty;
+
+    void markDirty() {
+        if (dirty) return;
+        dirty = true;
+        if (dirtyList) dirtyList->push_back(this);
+    }
 public:
-    IUser(const std::string& user, const std::string& hash) : username(user), passwordHash(hash) {}
+    IUser(const std::string& user, const std::string& hash, UserRole role)
+        : username(user), passwordHash(hash), role(role), dirty(true) {}
     virtual ~IUser() {}
-    std::string getUsername() const { return username; }
-    std::string getPasswordHash() const { return passwordHash; }
-    void setPasswordHash(const std::string& hash) { passwordHash = hash; }
-    virtual std::string getRole() const = 0;
+    // Логин не меняется после создания: UserManager индексирует ссылку на него
+    const std::string& getUsername() const { return username; }
+    const std::string& getPasswordHash() const { return passwordHash; }
+    void setPasswordHash(const std::string& hash) { passwordHash = hash; markDirty(); }
+    UserRole getRoleType() const { return role; }
+    bool isStudent() const { return role == UserRole::Student; }
+    // Название роли, как в users.txt
+    std::string_view getRole() const { return role == UserRole::Student ? "student" : "admin"; }
+
+    bool isDirty() const { return dirty; }
 };
 
 #endif
@@ -0,0 +1,140 @@
+#include "LoadGenerator.h"
+#include "NetSocket.h"
+#include "Utils.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+namespace {
+    // Отправляет команду и читает полный ответ (с учётом "LIST n" + n строк)
+    bool request(NetSocket& socket, const std::string& command, std::string& status) {
+        if (!socket.sendAll(command + "\n")) return false;
+        if (!socket.readLine(status)) return false;
+
+        int extra = 0;
+        if (status.compare(0, 5, "LIST ") == 0 && Utils::parseInt(std::string_view(status).substr(5), extra)) {
+            std::string line;
+            for (int i = 0; i < extra; ++i) {
+                if (!socket.readLine(line)) return false;
+            }
+        }
+        return true;
+    }
+
+    struct ClientResult {
+        std::vector<double> latencies;
+        long long errors = 0;
+    };
+
+    void runClient(const LoadGeneratorConfig& config, unsigned seed, ClientResult& result) {
+        NetSocket socket = NetSocket::connectLocal(config.port);
+        if (!socket.isValid()) {
+            result.errors += config.requestsPerClient;
+            return;
+        }
+
+        std::string status;
+        if (!request(socket, "LOGIN " + config.username + " " + config.password, status) ||
+            status.compare(0, 2, "OK") != 0) {
+            result.errors += config.requestsPerClient;
+            return;
+        }
+        if (!config.masterPassword.empty()) {
+            request(socket, "MASTER " + config.masterPassword, status);
+        }
+
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> percent(0, 99);
+        const char* reads[] = { "APPS", "MYAPPS", "HISTORY 20", "PENDING" };
+        int ownAppId = 0;   // поданная клиентом заявка, которую нужно отозвать
+
+        result.latencies.reserve(config.requestsPerClient);
+        for (int i = 0; i < config.requestsPerClient; ++i) {
+            // Запись - цикл "подать заявку / отозвать её"
+            std::string command;
+            bool apply = false;
+            if (percent(rng) < config.writePercent) {
+                apply = ownAppId == 0;
+                command = apply ? "APPLY 0" : "DELETE " + std::to_string(ownAppId);
+                if (!apply) ownAppId = 0;
+            }
+            else {
+                command = reads[i % 4];
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            bool sent = request(socket, command, status);
+            auto end = std::chrono::steady_clock::now();
+
+            if (!sent) {
+                result.errors += config.requestsPerClient - i;
+                return;
+            }
+            if (status.compare(0, 3, "ERR") == 0) result.errors++;
+            if (apply && status.compare(0, 3, "OK ") == 0) {
+                size_t space = status.rfind(' ');
+                Utils::parseInt(std::string_view(status).substr(space + 1), ownAppId);
+            }
+            result.latencies.push_back(
+                std::chrono::duration<double, std::micro>(end - begin).count());
+        }
+
+        request(socket, "QUIT", status);
+    }
+}
+
+LoadGeneratorReport LoadGenerator::run(const LoadGeneratorConfig& config) {
+    LoadGeneratorReport report;
+    if (!NetSocket::initialize()) return report;
+
+    std::vector<ClientResult> results(config.clients);
+    std::vector<std::thread> threads;
+    threads.reserve(config.clients);
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < config.clients; ++i) {
+        threads.emplace_back(runClient, std::cref(config), static_cast<unsigned>(i + 1),
+            std::ref(results[i]));
+    }
+    for (auto& thread : threads) thread.join();
+    auto end = std::chrono::steady_clock::now();
+
+    std::vector<double> latencies;
+    for (const auto& result : results) {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        report.errors += result.errors;
+    }
+
+    report.requests = static_cast<long long>(latencies.size());
+    report.seconds = std::chrono::duration<double>(end - begin).count();
+    if (report.seconds > 0) report.throughput = report.requests / report.seconds;
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        double sum = 0;
+        for (double l : latencies) sum += l;
+        report.avgLatencyUs = sum / latencies.size();
+        report.p50LatencyUs = latencies[latencies.size() / 2];
+        report.p99LatencyUs = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+        report.maxLatencyUs = latencies.back();
+    }
+    return report;
+}
+
+void LoadGenerator::printReport(const LoadGeneratorConfig& config, const LoadGeneratorReport& report) {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Нагрузка: " << config.clients << " клиентов x " << config.requestsPerClient
+        << " запросов (запись " << config.writePercent << "%), порт " << config.port << "\n";
+    std::cout << "Выполнено запросов: " << report.requests << ", ошибок: " << report.errors << "\n";
+    std::cout << "Время: " << report.seconds << " с, пропускная способность: "
+        << report.throughput << " запросов/с\n";
+    std::cout << "Задержка, мкс: средняя " << report.avgLatencyUs
+        << ", p50 " << report.p50LatencyUs
+        << ", p99 " << report.p99LatencyUs
+        << ", макс " << report.maxLatencyUs << "\n";
+}
@@ -0,0 +1,37 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <string>
+
+// Локальный клиент нагрузки для серверного режима: несколько потоков-клиентов
+// входят под одной учётной записью и шлют смесь запросов чтения (APPS, MYAPPS,
+// HISTORY, PENDING) и, при writePercent > 0, подачи/отзыва заявок.
+// В ошибки попадают и отказы по правилам (например, уже есть активная заявка).
+struct LoadGeneratorConfig {
+    int port = 5050;
+    int clients = 8;
+    int requestsPerClient = 1000;
+    int writePercent = 5;
+    std::string username;
+    std::string password;
+    std::string masterPassword;   // для администратора; пусто - без MASTER
+};
+
+struct LoadGeneratorReport {
+    long long requests = 0;
+    long long errors = 0;
+    double seconds = 0.0;
+    double throughput = 0.0;   // запросов в секунду
+    double avgLatencyUs = 0.0;
+    double p50LatencyUs = 0.0;
+    double p99LatencyUs = 0.0;
+    double maxLatencyUs = 0.0;
+};
+
+class LoadGenerator {
+public:
+    static LoadGeneratorReport run(const LoadGeneratorConfig& config);
+    static void printReport(const LoadGeneratorConfig& config, const LoadGeneratorReport& report);
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+    std::atomic<int> runtimeLevel{ static_cast<int>(LogLevel::Info) };
+
+    // Буфер строк и поток, выводящий их в output. Пока поток пишет
+    // накопленное, новые строки собираются в освободившийся буфер
+    class AsyncSink {
+        static constexpr size_t BUFFER_LIMIT = 1 << 20;
+
+        // Пачка выводится в поток, который был задан при её отборе: замена
+        // вывода не мешает записи уже отобранной пачки
+        std::shared_ptr<std::ostream> output{ &std::cerr, [](std::ostream*) {} };
+        std::string pending;
+        uint64_t appended = 0;     // строк поставлено
+        uint64_t written = 0;      // строк выведено
+        bool stopping = false;
+
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable drained;
+        std::thread worker;
+
+        void workerLoop() {
+            std::string batch;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                workAvailable.wait(lock, [this]() { return stopping || !pending.empty(); });
+                if (pending.empty()) break;
+
+                batch.swap(pending);
+                uint64_t batchEnd = appended;
+                std::shared_ptr<std::ostream> out = output;
+                lock.unlock();
+
+                out->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                out->flush();
+                batch.clear();
+                out.reset();
+
+                lock.lock();
+                written = batchEnd;
+                drained.notify_all();
+            }
+        }
+
+    public:
+        AsyncSink() : worker(&AsyncSink::workerLoop, this) {}
+
+        ~AsyncSink() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            workAvailable.notify_one();
+            worker.join();
+        }
+
+        void append(const std::string& line, bool wait) {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Переполненный буфер притормаживает источник, а не теряет строки
+            drained.wait(lock, [this]() { return pending.size() < BUFFER_LIMIT; });
+            bool wasEmpty = pending.empty();
+            pending += line;
+            uint64_t sequence = ++appended;
+            if (wasEmpty) workAvailable.notify_one();
+            if (wait) {
+                drained.wait(lock, [this, sequence]() { return written >= sequence; });
+            }
+        }
+
+        void flush() {
+            std::unique_lock<std::mutex> lock(mutex);
+            uint64_t target = appended;
+            drained.wait(lock, [this, target]() { return written >= target; });
+        }
+
+        void setOutput(std::shared_ptr<std::ostream> stream) {
+            // Накопленные строки относятся к прежнему выводу
+            std::unique_lock<std::mutex> lock(mutex);
+            uint64_t target = appended;
+            drained.wait(lock, [this, target]() { return written >= target; });
+            output = std::move(stream);
+        }
+    };
+
+    AsyncSink& sink() {
+        static AsyncSink instance;
+        return instance;
+    }
+
+    void appendTimestamp(std::string& out) {
+        auto now = std::chrono::system_clock::now();
+        std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+        int millis = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            now.time_since_epoch()).count() % 1000);
+
+        struct tm timeinfo;
+        localtime_s(&timeinfo, &seconds);
+        char buffer[32];
+        size_t length = strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+        snprintf(buffer + length, sizeof(buffer) - length, ".%03d ", millis);
+        out += buffer;
+    }
+}
+
+void Logger::setLevel(LogLevel level) {
+    runtimeLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel Logger::getLevel() {
+    return static_cast<LogLevel>(runtimeLevel.load(std::memory_order_relaxed));
+}
+
+bool Logger::isEnabled(LogLevel level) {
+    return static_cast<int>(level) >= runtimeLevel.load(std::memory_order_relaxed);
+}
+
+bool Logger::parseLevel(std::string_view name, LogLevel& level) {
+    if (name == "debug") level = LogLevel::Debug;
+    else if (name == "info") level = LogLevel::Info;
+    else if (name == "warn" || name == "warning") level = LogLevel::Warning;
+    else if (name == "error") level = LogLevel::Error;
+    else if (name == "off") level = LogLevel::Off;
+    else return false;
+    return true;
+}
+
+bool Logger::setOutput(const std::string& filename) {
+    if (filename.empty()) {
+        sink().setOutput(std::shared_ptr<std::ostream>(&std::cerr, [](std::ostream*) {}));
+        return true;
+    }
+
+    auto file = std::make_shared<std::ofstream>(filename, std::ios::app);
+    if (!file->is_open()) return false;
+    sink().setOutput(std::move(file));
+    return true;
+}
+
+const char* Logger::levelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info: return "INFO ";
+    case LogLevel::Warning: return "WARN ";
+    case LogLevel::Error: return "ERROR";
+    default: return "";
+    }
+}
+
+void Logger::write(LogLevel level, std::string_view component, std::string_view message) {
+    std::string line;
+    line.reserve(32 + component.size() + message.size());
+    appendTimestamp(line);
+    line += levelName(level);
+    line += ' ';
+    line += component;
+    line += ": ";
+    line += message;
+    line += '\n';
+    sink().append(line, level >= LogLevel::Warning);
+}
+
+void Logger::flush() {
+    sink().flush();
+}
@@ -0,0 +1,63 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <string>
+#include <string_view>
+#include <sstream>
+
+enum class LogLevel { Debug = 0, Info = 1, Warning = 2, Error = 3, Off = 4 };
+
+// Минимальный уровень, попадающий в сборку. Вызовы ниже него вырезаются
+// компилятором вместе с форматированием аргументов. По умолчанию отладочные
+// сообщения есть только в Debug-конфигурации
+#ifndef LOG_COMPILE_LEVEL
+#ifdef _DEBUG
+#define LOG_COMPILE_LEVEL 0
+#else
+#define LOG_COMPILE_LEVEL 1
+#endif
+#endif
+
+// Общий журнал сообщений менеджеров. Строка имеет вид
+//   2026-10-18 14:03:27.512 INFO  UserManager: сообщение ключ=значение ...
+// Строки копятся в буфере и выводятся фоновым потоком пачками в stderr или
+// файл (setOutput), но не в std::cout, куда пишет интерфейс. Предупреждения
+// и ошибки дожидаются вывода, чтобы не потеряться при аварии
+class Logger {
+public:
+    // Уровень во время работы; не может включить вырезанные при компиляции
+    static void setLevel(LogLevel level);
+    static LogLevel getLevel();
+    static bool isEnabled(LogLevel level);
+    // "debug", "info", "warn", "error" или "off"
+    static bool parseLevel(std::string_view name, LogLevel& level);
+
+    // Пустое имя - stderr, иначе дозапись в файл. Строки, записанные до
+    // вызова, выводятся в прежнее место. false, если файл не открылся
+    static bool setOutput(const std::string& filename);
+
+    static void write(LogLevel level, std::string_view component, std::string_view message);
+    // Дожидается вывода всех записанных до вызова строк
+    static void flush();
+
+    static const char* levelName(LogLevel level);
+};
+
+// LOG_INFO("UserManager", "Загружено: users=" << count << " ms=" << ms);
+#define LOG_AT(level, component, expr)                                      \
+    do {                                                                    \
+        if constexpr (static_cast<int>(level) >= LOG_COMPILE_LEVEL) {       \
+            if (Logger::isEnabled(level)) {                                 \
+                std::ostringstream logStream_;                              \
+                logStream_ << expr;                                         \
+                Logger::write(level, component, logStream_.str());          \
+            }                                                               \
+        }                                                                   \
+    } while (0)
+
+#define LOG_DEBUG(component, expr) LOG_AT(LogLevel::Debug, component, expr)
+#define LOG_INFO(component, expr) LOG_AT(LogLevel::Info, component, expr)
+#define LOG_WARN(component, expr) LOG_AT(LogLevel::Warning, component, expr)
+#define LOG_ERROR(component, expr) LOG_AT(LogLevel::Error, component, expr)
+
+#endif
@@ -0,0 +1,158 @@
+#include "NetSocket.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+using SocketHandle = SOCKET;
+static const std::intptr_t INVALID_HANDLE = static_cast<std::intptr_t>(INVALID_SOCKET);
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+using SocketHandle = int;
+static const std::intptr_t INVALID_HANDLE = -1;
+#endif
+
+namespace {
+    SocketHandle toNative(std::intptr_t h) {
+        return static_cast<SocketHandle>(h);
+    }
+
+    sockaddr_in localAddress(int port) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<unsigned short>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return addr;
+    }
+
+    void disableNagle(SocketHandle s) {
+        int flag = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&flag), sizeof(flag));
+    }
+}
+
+NetSocket::NetSocket() : handle(INVALID_HANDLE) {}
+
+NetSocket::NetSocket(NetSocket&& other) noexcept
+    : handle(other.handle), buffer(std::move(other.buffer)) {
+    other.handle = INVALID_HANDLE;
+}
+
+NetSocket& NetSocket::operator=(NetSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle = other.handle;
+        buffer = std::move(other.buffer);
+        other.handle = INVALID_HANDLE;
+    }
+    return *this;
+}
+
+bool NetSocket::initialize() {
+#ifdef _WIN32
+    static bool initialized = false;
+    if (!initialized) {
+        WSADATA data;
+        initialized = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+    return initialized;
+#else
+    return true;
+#endif
+}
+
+NetSocket NetSocket::listenLocal(int port) {
+    SocketHandle s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (static_cast<std::intptr_t>(s) == INVALID_HANDLE) return NetSocket();
+    NetSocket result(static_cast<std::intptr_t>(s));
+
+    int reuse = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in addr = localAddress(port);
+    if (bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(s, SOMAXCONN) != 0) {
+        return NetSocket();
+    }
+    return result;
+}
+
+NetSocket NetSocket::connectLocal(int port) {
+    SocketHandle s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (static_cast<std::intptr_t>(s) == INVALID_HANDLE) return NetSocket();
+    NetSocket result(static_cast<std::intptr_t>(s));
+
+    sockaddr_in addr = localAddress(port);
+    if (connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        return NetSocket();
+    }
+    disableNagle(s);
+    return result;
+}
+
+NetSocket NetSocket::accept() {
+    SocketHandle s = ::accept(toNative(handle), nullptr, nullptr);
+    if (static_cast<std::intptr_t>(s) == INVALID_HANDLE) return NetSocket();
+    disableNagle(s);
+    return NetSocket(static_cast<std::intptr_t>(s));
+}
+
+bool NetSocket::isValid() const {
+    return handle != INVALID_HANDLE;
+}
+
+void NetSocket::close() {
+    if (handle == INVALID_HANDLE) return;
+#ifdef _WIN32
+    closesocket(toNative(handle));
+#else
+    ::close(toNative(handle));
+#endif
+    handle = INVALID_HANDLE;
+}
+
+void NetSocket::shutdown() {
+    if (handle == INVALID_HANDLE) return;
+#ifdef _WIN32
+    ::shutdown(toNative(handle), SD_BOTH);
+#else
+    ::shutdown(toNative(handle), SHUT_RDWR);
+#endif
+}
+
+bool NetSocket::sendAll(std::string_view data) {
+    while (!data.empty()) {
+        int chunk = data.size() > (1u << 30) ? (1 << 30) : static_cast<int>(data.size());
+#ifdef _WIN32
+        int sent = send(toNative(handle), data.data(), chunk, 0);
+#else
+        int sent = static_cast<int>(send(toNative(handle), data.data(), chunk, MSG_NOSIGNAL));
+#endif
+        if (sent <= 0) return false;
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+
+bool NetSocket::readLine(std::string& line) {
+    while (true) {
+        size_t pos = buffer.find('\n');
+        if (pos != std::string::npos) {
+            line.assign(buffer, 0, pos);
+            buffer.erase(0, pos + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            return true;
+        }
+
+        char chunk[4096];
+        int received = static_cast<int>(recv(toNative(handle), chunk, sizeof(chunk), 0));
+        if (received <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(received));
+    }
+}
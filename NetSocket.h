@@ -0,0 +1,41 @@
+#ifndef NETSOCKET_H
+#define NETSOCKET_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// TCP-сокет на локальном интерфейсе (127.0.0.1) с построчным чтением
+class NetSocket {
+    std::intptr_t handle;
+    std::string buffer;   // принятые, но ещё не прочитанные данные
+
+    explicit NetSocket(std::intptr_t h) : handle(h) {}
+
+public:
+    NetSocket();
+    ~NetSocket() { close(); }
+
+    NetSocket(const NetSocket&) = delete;
+    NetSocket& operator=(const NetSocket&) = delete;
+    NetSocket(NetSocket&& other) noexcept;
+    NetSocket& operator=(NetSocket&& other) noexcept;
+
+    // Инициализация сетевой подсистемы (WSAStartup в Windows)
+    static bool initialize();
+
+    static NetSocket listenLocal(int port);
+    static NetSocket connectLocal(int port);
+    NetSocket accept();
+
+    bool isValid() const;
+    void close();
+    // Прерывает блокирующие accept/recv в других потоках
+    void shutdown();
+
+    bool sendAll(std::string_view data);
+    // Читает строку без завершающего '\n' (и '\r'); false - соединение закрыто
+    bool readLine(std::string& line);
+};
+
+#endif
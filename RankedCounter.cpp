@@ -0,0 +1,67 @@
+#include "RankedCounter.h"
+#include <algorithm>
+
+void RankedCounter::ensureGroup(int value) {
+    if (static_cast<size_t>(value) >= groupSize.size()) {
+        groupStart.resize(value + 1, 0);
+        groupSize.resize(value + 1, 0);
+    }
+}
+
+void RankedCounter::increment(uint32_t id) {
+    if (id >= counts.size()) {
+        // Новые идентификаторы встают в конец с нулевым значением
+        ensureGroup(0);
+        for (uint32_t newId = static_cast<uint32_t>(counts.size()); newId <= id; ++newId) {
+            if (groupSize[0] == 0) groupStart[0] = ranking.size();
+            groupSize[0]++;
+            rankOf.push_back(ranking.size());
+            ranking.push_back(newId);
+            counts.push_back(0);
+        }
+    }
+
+    // Меняем id местами с первым элементом его группы: он становится
+    // последним элементом группы value + 1, которая стоит прямо перед ней
+    int value = counts[id];
+    ensureGroup(value + 1);
+
+    size_t first = groupStart[value];
+    size_t current = rankOf[id];
+    uint32_t other = ranking[first];
+    std::swap(ranking[first], ranking[current]);
+    rankOf[other] = current;
+    rankOf[id] = first;
+
+    groupStart[value]++;
+    groupSize[value]--;
+    if (groupSize[value + 1] == 0) groupStart[value + 1] = first;
+    groupSize[value + 1]++;
+    counts[id] = value + 1;
+}
+
+void RankedCounter::add(uint32_t id, int amount) {
+    for (int i = 0; i < amount; ++i) {
+        increment(id);
+    }
+}
+
+std::vector<std::pair<uint32_t, int>> RankedCounter::top(size_t k) const {
+    std::vector<std::pair<uint32_t, int>> result;
+    size_t count = std::min(k, ranking.size());
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t id = ranking[i];
+        if (counts[id] == 0) break;
+        result.emplace_back(id, counts[id]);
+    }
+    return result;
+}
+
+void RankedCounter::clear() {
+    counts.clear();
+    ranking.clear();
+    rankOf.clear();
+    groupStart.clear();
+    groupSize.clear();
+}
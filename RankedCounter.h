@@ -0,0 +1,34 @@
+#ifndef RANKEDCOUNTER_H
+#define RANKEDCOUNTER_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Счётчики по идентификаторам (например, из StringDictionary), которые
+// только растут. Идентификаторы всегда упорядочены по убыванию счётчика:
+// увеличение - O(1), первые K мест - O(K).
+class RankedCounter {
+    std::vector<int> counts;          // id -> значение
+    std::vector<uint32_t> ranking;    // id по убыванию значения
+    std::vector<size_t> rankOf;       // id -> место в ranking
+    // Идентификаторы с одинаковым значением c занимают в ranking
+    // непрерывный отрезок [groupStart[c], groupStart[c] + groupSize[c])
+    std::vector<size_t> groupStart;
+    std::vector<size_t> groupSize;
+
+    void ensureGroup(int value);
+
+public:
+    void increment(uint32_t id);
+    // Увеличение на amount - это amount шагов increment, O(amount)
+    void add(uint32_t id, int amount);
+    int count(uint32_t id) const { return id < counts.size() ? counts[id] : 0; }
+
+    // До k пар (id, значение) с наибольшими значениями
+    std::vector<std::pair<uint32_t, int>> top(size_t k) const;
+
+    void clear();
+};
+
+#endif
@@ -5,11 +5,11 @@
 #include <vector>
 
 enum class ScholarshipCategory {
-    Academic,      // 
-    Social,        // 
-    Named,         // 
-    Personal,      // 
-    Presidential   // 
+    Academic,      // Учебная
+    Social,        // Социальная
+    Named,         // Именная
+    Personal,      // Персональная
+    Presidential   // Президентская
 };
 
 struct ScholarshipRequirement {
@@ -0,0 +1,352 @@
+#include "SessionServer.h"
+#include "UserManager.h"
+#include "ApplicationManager.h"
+#include "ScholarshipTypeManager.h"
+#include "SecurityManager.h"
+#include "Student.h"
+#include "Utils.h"
+#include <sstream>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    std::vector<std::string> splitArgs(const std::string& line) {
+        std::vector<std::string> args;
+        std::istringstream ss(line);
+        std::string word;
+        while (ss >> word) args.push_back(word);
+        return args;
+    }
+
+    std::string ok(const std::string& text) {
+        return "OK " + text + "\n";
+    }
+
+    std::string err(const std::string& text) {
+        return "ERR " + text + "\n";
+    }
+
+    // Многострочный ответ: "LIST n", затем n строк
+    std::string okLines(const std::vector<std::string>& lines) {
+        std::string out = "LIST " + std::to_string(lines.size()) + "\n";
+        for (const auto& line : lines) {
+            out += line;
+            out += '\n';
+        }
+        return out;
+    }
+
+    bool parseId(const std::vector<std::string>& args, size_t index, int& value) {
+        return args.size() > index && Utils::parseInt(args[index], value);
+    }
+}
+
+SessionServer::SessionServer(UserManager& users, ApplicationManager& apps,
+    ScholarshipTypeManager& scholarships, SecurityManager& sec,
+    int port, size_t threadCount)
+    : userManager(users), appManager(apps), scholarshipManager(scholarships),
+    security(sec), port(port), pool(threadCount), running(false),
+    requestCount(0), activeSessions(0) {
+}
+
+SessionServer::~SessionServer() {
+    stop();
+}
+
+bool SessionServer::start() {
+    if (running) return true;
+    if (!NetSocket::initialize()) return false;
+
+    listener = NetSocket::listenLocal(port);
+    if (!listener.isValid()) return false;
+
+    running = true;
+    acceptThread = std::thread([this]() { acceptLoop(); });
+    return true;
+}
+
+void SessionServer::stop() {
+    if (!running.exchange(false)) return;
+
+    // Дескриптор слушающего сокета закрывается только после выхода потока
+    // из accept. shutdown прерывает accept не везде (в Windows - нет),
+    // поэтому поток дополнительно будится пробным подключением
+    listener.shutdown();
+    if (acceptThread.joinable()) {
+        NetSocket wakeup = NetSocket::connectLocal(port);
+        acceptThread.join();
+    }
+    listener.close();
+
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        for (auto& client : clients) client->shutdown();
+    }
+    pool.shutdown();
+}
+
+void SessionServer::acceptLoop() {
+    while (running) {
+        NetSocket client = listener.accept();
+        if (!running) break;
+        if (!client.isValid()) continue;
+
+        auto shared = std::make_shared<NetSocket>(std::move(client));
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            clients.push_back(shared);
+        }
+        pool.submit([this, shared]() { serveClient(shared); });
+    }
+}
+
+void SessionServer::serveClient(std::shared_ptr<NetSocket> client) {
+    ++activeSessions;
+    Session session;
+    std::string line;
+    bool quit = false;
+
+    while (running && !quit && client->readLine(line)) {
+        if (line.empty()) continue;
+
+        std::string response;
+        try {
+            response = handleCommand(session, line, quit);
+        }
+        catch (const std::exception& e) {
+            response = err(std::string("внутренняя ошибка: ") + e.what());
+        }
+        ++requestCount;
+
+        if (!client->sendAll(response)) break;
+    }
+
+    {
+        // Закрытие под clientsMutex: stop не обратится к уже закрытому дескриптору
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+        client->close();
+    }
+    --activeSessions;
+}
+
+std::string SessionServer::handleCommand(Session& session, const std::string& line, bool& quit) {
+    std::vector<std::string> args = splitArgs(line);
+    if (args.empty()) return err("пустая команда");
+
+    std::string command = args[0];
+    std::transform(command.begin(), command.end(), command.begin(),
+        [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    if (command == "QUIT") {
+        quit = true;
+        return ok("до свидания");
+    }
+    if (command == "LOGIN") return cmdLogin(session, args);
+
+    if (!session.user) return err("требуется LOGIN");
+
+    if (command == "MASTER") return cmdMaster(session, args);
+    if (command == "APPS") return cmdApps(session, false, false);
+    if (command == "MYAPPS") return cmdApps(session, true, false);
+    if (command == "PENDING") return cmdApps(session, false, true);
+    if (command == "APP") return cmdApp(session, args);
+    if (command == "HISTORY") return cmdHistory(session, args);
+    if (command == "APPLY") return cmdApply(session, args);
+    if (command == "STATUS") return cmdStatus(session, args);
+    if (command == "DELETE") return cmdDelete(session, args);
+
+    return err("неизвестная команда " + args[0]);
+}
+
+std::string SessionServer::cmdLogin(Session& session, const std::vector<std::string>& args) {
+    if (args.size() != 3) return err("формат: LOGIN <логин> <пароль>");
+
+    std::shared_lock<std::shared_mutex> lock(stateMutex);
+    auto user = userManager.findUser(args[1]);
+    if (!user || user->getPasswordHash() != Utils::hashPassword(args[2])) {
+        return err("неверный логин или пароль");
+    }
+
+    session.user = user;
+    session.isAdmin = !user->isStudent();
+    session.adminVerified = false;
+    return ok(session.isAdmin ? "admin, требуется MASTER" : "student");
+}
+
+std::string SessionServer::cmdMaster(Session& session, const std::vector<std::string>& args) {
+    if (!session.isAdmin) return err("команда доступна только администратору");
+    if (args.size() != 2) return err("формат: MASTER <мастер-пароль>");
+
+    // verifyMasterPassword меняет счётчик попыток и config.txt
+    std::unique_lock<std::shared_mutex> lock(stateMutex);
+    if (security.isLocked()) return err("система заблокирована, попробуйте позже");
+    if (!security.verifyMasterPassword(args[1])) return err("неверный мастер-пароль");
+
+    session.adminVerified = true;
+    return ok("доступ администратора открыт");
+}
+
+std::string SessionServer::cmdApps(const Session& session, bool onlyOwn, bool onlyPending) const {
+    bool own = onlyOwn || !session.isAdmin;
+    if (!own && !session.adminVerified) return err("требуется MASTER");
+
+    // Заявки берутся под блокировкой, а форматируются уже без неё
+    std::vector<Application> ownApps;
+    ApplicationsSnapshot allApps;
+    {
+        std::shared_lock<std::shared_mutex> lock(stateMutex);
+        if (own) ownApps = appManager.getApplicationsByStudent(session.user->getUsername());
+        else allApps = appManager.getAllApplications();
+    }
+
+    std::vector<std::string> lines;
+    auto format = [&](const Application& app) {
+        if (onlyPending && app.getStatus() != ApplicationStatus::Pending) return;
+        lines.push_back(app.saveToString());
+    };
+    if (own) {
+        lines.reserve(ownApps.size());
+        for (const auto& app : ownApps) format(app);
+    }
+    else {
+        lines.reserve(allApps.size());
+        for (const auto& app : allApps) format(app);
+    }
+    return okLines(lines);
+}
+
+std::string SessionServer::cmdApp(const Session& session, const std::vector<std::string>& args) const {
+    int id = 0;
+    if (!parseId(args, 1, id)) return err("формат: APP <id>");
+
+    std::shared_lock<std::shared_mutex> lock(stateMutex);
+    const Application* app = appManager.getApplicationById(id);
+    if (!app) return err("заявка не найдена");
+    if (!session.adminVerified && app->getStudentUsername() != session.user->getUsername()) {
+        return err("нет доступа к заявке");
+    }
+    return ok(app->saveToString());
+}
+
+std::string SessionServer::cmdHistory(const Session& session, const std::vector<std::string>& args) const {
+    int limit = 20;
+    if (args.size() > 1 && (!Utils::parseInt(args[1], limit) || limit <= 0)) {
+        return err("формат: HISTORY [количество]");
+    }
+    if (session.isAdmin && !session.adminVerified) return err("требуется MASTER");
+
+    // Последние limit записей, новые первыми
+    HistoryFilter filter;
+    if (!session.adminVerified) filter.withStudent(session.user->getUsername());
+
+    HistoryPage page;
+    {
+        std::shared_lock<std::shared_mutex> lock(stateMutex);
+        page = appManager.getHistory().query(filter).limit(static_cast<size_t>(limit)).fetch();
+    }
+
+    std::vector<std::string> lines;
+    lines.reserve(page.records.size());
+    for (const auto& record : page.records) {
+        lines.push_back(record.toString());
+    }
+    return okLines(lines);
+}
+
+std::string SessionServer::persisted(const std::string& reply) {
+    // Ожидание диска идёт без блокировки состояния: другие сессии
+    // продолжают работу, а записи нескольких изменений сливаются
+    if (!appManager.flush()) {
+        return err("изменение выполнено, но не записано на диск");
+    }
+    return reply;
+}
+
+std::string SessionServer::cmdApply(Session& session, const std::vector<std::string>& args) {
+    if (session.isAdmin) return err("подавать заявки могут только студенты");
+
+    int categoryValue = 0;
+    if (!parseId(args, 1, categoryValue) || categoryValue < 0 ||
+        categoryValue > static_cast<int>(ScholarshipCategory::Presidential)) {
+        return err("формат: APPLY <категория 0-4>");
+    }
+    ScholarshipCategory category = static_cast<ScholarshipCategory>(categoryValue);
+    auto student = std::static_pointer_cast<Student>(session.user);
+
+    std::unique_lock<std::shared_mutex> lock(stateMutex);
+    if (appManager.getPendingApplicationsCount(student->getUsername()) > 0) {
+        return err("уже есть заявка в статусе 'Ожидание'");
+    }
+
+    auto available = scholarshipManager.getAvailableScholarshipsForStudent(
+        student->getAverageGrade(),
+        student->getHasSocialBenefits(),
+        student->getHasScientificWorks(),
+        student->getConferencesCount(),
+        student->getIsActiveInCommunity());
+    bool allowed = std::any_of(available.begin(), available.end(),
+        [category](const std::shared_ptr<ScholarshipType>& type) {
+            return type->getCategory() == category;
+        });
+    if (!allowed) return err("требования стипендии не выполнены");
+
+    Application app(student->getUsername(), student->getAverageGrade(),
+        category, ApplicationStatus::Pending);
+    if (!appManager.addApplication(app)) return err("не удалось добавить заявку");
+    appManager.saveApplications();
+    lock.unlock();
+    return persisted(ok("заявка " + std::to_string(app.getId())));
+}
+
+std::string SessionServer::cmdStatus(Session& session, const std::vector<std::string>& args) {
+    if (!session.adminVerified) return err("требуется MASTER");
+
+    int id = 0;
+    if (!parseId(args, 1, id) || args.size() != 3) {
+        return err("формат: STATUS <id> approve|reject|pending");
+    }
+
+    ApplicationStatus status;
+    if (args[2] == "approve") status = ApplicationStatus::Approved;
+    else if (args[2] == "reject") status = ApplicationStatus::Rejected;
+    else if (args[2] == "pending") status = ApplicationStatus::Pending;
+    else return err("неизвестный статус " + args[2]);
+
+    std::unique_lock<std::shared_mutex> lock(stateMutex);
+    if (!appManager.updateApplicationStatusById(id, status, session.user->getUsername())) {
+        return err("заявка не найдена");
+    }
+    appManager.saveApplications();
+    lock.unlock();
+    return persisted(ok("статус обновлён"));
+}
+
+std::string SessionServer::cmdDelete(Session& session, const std::vector<std::string>& args) {
+    int id = 0;
+    if (!parseId(args, 1, id)) return err("формат: DELETE <id>");
+
+    std::unique_lock<std::shared_mutex> lock(stateMutex);
+    const Application* app = appManager.getApplicationById(id);
+    if (!app) return err("заявка не найдена");
+
+    std::string deleter;
+    if (session.adminVerified) {
+        deleter = session.user->getUsername();
+    }
+    else {
+        // Студент может отозвать только свою заявку в статусе 'Ожидание'
+        if (session.isAdmin || app->getStudentUsername() != session.user->getUsername()) {
+            return err("нет доступа к заявке");
+        }
+        if (app->getStatus() != ApplicationStatus::Pending) {
+            return err("отозвать можно только заявку в статусе 'Ожидание'");
+        }
+        deleter = "student_" + session.user->getUsername();
+    }
+
+    if (!appManager.removeApplicationById(id, deleter)) return err("не удалось удалить заявку");
+    appManager.saveApplications();
+    lock.unlock();
+    return persisted(ok("заявка удалена"));
+}
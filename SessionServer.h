@@ -0,0 +1,94 @@
+#ifndef SESSIONSERVER_H
+#define SESSIONSERVER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include "NetSocket.h"
+#include "ThreadPool.h"
+
+class UserManager;
+class ApplicationManager;
+class ScholarshipTypeManager;
+class SecurityManager;
+class IUser;
+
+// Серверный режим: несколько одновременных сессий студентов и администраторов
+// над общими менеджерами. Протокол построчный (127.0.0.1:port):
+//   LOGIN <логин> <пароль>          MASTER <мастер-пароль>
+//   APPS | MYAPPS | PENDING | APP <id> | HISTORY [n]
+//   APPLY <категория 0-4> | STATUS <id> approve|reject|pending | DELETE <id>
+//   QUIT
+// Ответ: "OK <текст>", "LIST <n>" и n строк данных, либо "ERR <сообщение>".
+// Чтения выполняются под разделяемой блокировкой и идут параллельно,
+// изменения - под исключительной. Запись на диск идёт фоновым потоком, но
+// ответ на изменение отправляется только после неё (уже без блокировки).
+// Каждое подключение обслуживается одним потоком пула, поэтому число
+// одновременно активных сессий равно размеру пула, остальные ждут в очереди.
+class SessionServer {
+    UserManager& userManager;
+    ApplicationManager& appManager;
+    ScholarshipTypeManager& scholarshipManager;
+    SecurityManager& security;
+
+    int port;
+    NetSocket listener;
+    ThreadPool pool;
+    std::thread acceptThread;
+    std::atomic<bool> running;
+
+    mutable std::shared_mutex stateMutex;
+
+    // Открытые подключения: при остановке их чтение прерывается
+    std::mutex clientsMutex;
+    std::vector<std::shared_ptr<NetSocket>> clients;
+
+    // Состояние одного подключения
+    struct Session {
+        std::shared_ptr<IUser> user;
+        bool isAdmin = false;
+        bool adminVerified = false;   // мастер-пароль введён
+    };
+
+    std::atomic<long long> requestCount;
+    std::atomic<int> activeSessions;
+
+    void acceptLoop();
+    void serveClient(std::shared_ptr<NetSocket> client);
+    std::string handleCommand(Session& session, const std::string& line, bool& quit);
+
+    std::string cmdLogin(Session& session, const std::vector<std::string>& args);
+    std::string cmdMaster(Session& session, const std::vector<std::string>& args);
+    std::string cmdApps(const Session& session, bool onlyOwn, bool onlyPending) const;
+    std::string cmdApp(const Session& session, const std::vector<std::string>& args) const;
+    std::string cmdHistory(const Session& session, const std::vector<std::string>& args) const;
+    std::string cmdApply(Session& session, const std::vector<std::string>& args);
+    std::string cmdStatus(Session& session, const std::vector<std::string>& args);
+    std::string cmdDelete(Session& session, const std::vector<std::string>& args);
+    // Дожидается записи изменения на диск перед ответом клиенту
+    std::string persisted(const std::string& reply);
+
+public:
+    SessionServer(UserManager& users, ApplicationManager& apps,
+        ScholarshipTypeManager& scholarships, SecurityManager& sec,
+        int port, size_t threadCount);
+    ~SessionServer();
+
+    SessionServer(const SessionServer&) = delete;
+    SessionServer& operator=(const SessionServer&) = delete;
+
+    bool start();
+    // Останавливает приём подключений и дожидается завершения сессий
+    void stop();
+
+    bool isRunning() const { return running; }
+    int getPort() const { return port; }
+    long long getRequestCount() const { return requestCount; }
+    int getActiveSessions() const { return activeSessions; }
+};
+
+#endif
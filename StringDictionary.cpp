@@ -0,0 +1,23 @@
+#include "StringDictionary.h"
+
+uint32_t StringDictionary::intern(std::string_view s) {
+    auto it = ids.find(s);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(strings.size());
+    strings.emplace_back(s);
+    ids.emplace(std::string_view(strings.back()), id);
+    return id;
+}
+
+uint32_t StringDictionary::find(std::string_view s) const {
+    auto it = ids.find(s);
+    return it != ids.end() ? it->second : NOT_FOUND;
+}
+
+void StringDictionary::clear() {
+    ids.clear();
+    strings.clear();
+}
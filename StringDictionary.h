@@ -0,0 +1,27 @@
+#ifndef STRINGDICTIONARY_H
+#define STRINGDICTIONARY_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+
+// Словарь (интернирование) строк: каждой уникальной строке
+// сопоставляется 32-битный идентификатор
+class StringDictionary {
+    std::deque<std::string> strings;   // deque не перемещает элементы при добавлении
+    std::unordered_map<std::string_view, uint32_t> ids;
+
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    uint32_t intern(std::string_view s);
+    uint32_t find(std::string_view s) const;
+    const std::string& str(uint32_t id) const { return strings[id]; }
+
+    size_t size() const { return strings.size(); }
+    void clear();
+};
+
+#endif
@@ -13,7 +13,7 @@ Student::Student(const std::string& user, const std::string& hash,
     const std::string& scientificWorksComment,
     const std::string& conferencesComment,
     const std::string& communityActivityComment)
-    : IUser(user, hash), fio(fio_), averageGrade(avg),
+    : IUser(user, hash, UserRole::Student), fio(fio_), averageGrade(avg),
     hasScholarship(hasScholarship), hasSocialBenefits(hasSocialBenefits),
     hasScientificWorks(hasScientificWorks), conferencesCount(conferences),
     isActiveInCommunity(activeInCommunity), studyForm(form),
@@ -24,41 +24,45 @@ Student::Student(const std::string& user, const std::string& hash,
     conferencesComment(conferencesComment),
     communityActivityComment(communityActivityComment) {}
 
+Student::~Student() {
+    if (table) table->detach(*this);
+}
+
 std::string Student::getFullInfo() const {
     std::stringstream ss;
-    ss << "=====     =====\n\n";
-    ss << " :\n";
-    ss << "  : " << fio << "\n";
-    ss << "  : " << username << "\n";
-    ss << "   : " << getStudyFormString() << "\n";
-    ss << "  : " << course << "\n";
-    ss << "  : " << group << "\n";
-    ss << "  : " << faculty << "\n";
-    ss << "  : " << specialty << "\n\n";
+    ss << "===== ПОЛНАЯ ИНФОРМАЦИЯ О СТУДЕНТЕ =====\n\n";
+    ss << "ОСНОВНАЯ ИНФОРМАЦИЯ:\n";
+    ss << "  ФИО: " << fio << "\n";
+    ss << "  Логин: " << username << "\n";
+    ss << "  Форма обучения: " << getStudyFormString() << "\n";
+    ss << "  Курс: " << getCourse() << "\n";
+    ss << "  Группа: " << group << "\n";
+    ss << "  Факультет: " << getFaculty() << "\n";
+    ss << "  Специальность: " << specialty << "\n\n";
 
-    ss << " :\n";
-    ss << "   : " << std::fixed << std::setprecision(2) << averageGrade << "/10.0\n";
-    ss << "  : " << (hasScholarship ? "" : " ") << "\n";
-    if (hasScholarship && !scholarshipType.empty()) {
-        ss << "   : " << scholarshipType << "\n";
+    ss << "АКАДЕМИЧЕСКАЯ ИНФОРМАЦИЯ:\n";
+    ss << "  Средний балл: " << std::fixed << std::setprecision(2) << getAverageGrade() << "/10.0\n";
+    ss << "  Стипендия: " << (getHasScholarship() ? "Назначена" : "Не назначена") << "\n";
+    if (getHasScholarship() && !scholarshipType.empty()) {
+        ss << "  Тип стипендии: " << scholarshipType << "\n";
     }
-    ss << "   : " << (hasSocialBenefits ? "" : "") << "\n";
-    ss << "   : " << (hasScientificWorks ? "" : "") << "\n";
-    ss << "    : " << conferencesCount << " ()\n";
-    ss << "   : " << (isActiveInCommunity ? "" : "") << "\n\n";
+    ss << "  Социальные льготы: " << (getHasSocialBenefits() ? "Да" : "Нет") << "\n";
+    ss << "  Научные работы: " << (getHasScientificWorks() ? "Да" : "Нет") << "\n";
+    ss << "  Участие в конференциях: " << getConferencesCount() << " раз(а)\n";
+    ss << "  Общественная активность: " << (getIsActiveInCommunity() ? "Да" : "Нет") << "\n\n";
 
-    ss << "   :\n";
+    ss << "КОММЕНТАРИИ И ДОПОЛНИТЕЛЬНАЯ ИНФОРМАЦИЯ:\n";
     if (!socialBenefitsComment.empty()) {
-        ss << "    (): " << socialBenefitsComment << "\n";
+        ss << "  Социальные льготы (комментарий): " << socialBenefitsComment << "\n";
     }
     if (!scientificWorksComment.empty()) {
-        ss << "    (): " << scientificWorksComment << "\n";
+        ss << "  Научные работы (комментарий): " << scientificWorksComment << "\n";
     }
     if (!conferencesComment.empty()) {
-        ss << "     (): " << conferencesComment << "\n";
+        ss << "  Участие в конференциях (комментарий): " << conferencesComment << "\n";
     }
     if (!communityActivityComment.empty()) {
-        ss << "    (): " << communityActivityComment << "\n";
+        ss << "  Общественная активность (комментарий): " << communityActivityComment << "\n";
     }
 
     return ss.str();
@@ -66,57 +70,57 @@ std::string Student::getFullInfo() const {
 
 std::string Student::getBasicInfo() const {
     std::stringstream ss;
-    ss << ": " << fio << " | ";
-    ss << ": " << username << " | ";
-    ss << ": " << course << " | ";
-    ss << ": " << group << " | ";
-    ss << ": " << faculty << " | ";
-    ss << ": " << getStudyFormString() << " | ";
-    ss << ": " << (hasScholarship ? (scholarshipType.empty() ? "" : scholarshipType) : "");
+    ss << "ФИО: " << fio << " | ";
+    ss << "Логин: " << username << " | ";
+    ss << "Курс: " << getCourse() << " | ";
+    ss << "Группа: " << group << " | ";
+    ss << "Факультет: " << getFaculty() << " | ";
+    ss << "Обучение: " << getStudyFormString() << " | ";
+    ss << "Стипендия: " << (getHasScholarship() ? (scholarshipType.empty() ? "Да" : scholarshipType) : "Нет");
     return ss.str();
 }
 
 std::string Student::getAcademicInfo() const {
     std::stringstream ss;
-    ss << " : " << std::fixed << std::setprecision(2) << averageGrade << "/10.0\n";
-    ss << ": " << specialty << "\n";
-    ss << " : " << (hasScientificWorks ? "" : "") << "\n";
-    ss << ": " << conferencesCount << "\n";
-    ss << " : " << (isActiveInCommunity ? "" : "") << "\n";
-    ss << " : " << (hasSocialBenefits ? "" : "") << "\n";
+    ss << "Средний балл: " << std::fixed << std::setprecision(2) << getAverageGrade() << "/10.0\n";
+    ss << "Специальность: " << specialty << "\n";
+    ss << "Научные работы: " << (getHasScientificWorks() ? "Да" : "Нет") << "\n";
+    ss << "Конференции: " << getConferencesCount() << "\n";
+    ss << "Общественная активность: " << (getIsActiveInCommunity() ? "Да" : "Нет") << "\n";
+    ss << "Социальные льготы: " << (getHasSocialBenefits() ? "Да" : "Нет") << "\n";
     return ss.str();
 }
 
 std::string Student::getCommentsInfo() const {
     std::stringstream ss;
-    ss << ":\n";
+    ss << "КОММЕНТАРИИ:\n";
 
     if (!socialBenefitsComment.empty()) {
-        ss << "   : " << socialBenefitsComment << "\n";
+        ss << "  Социальные льготы: " << socialBenefitsComment << "\n";
     }
     else {
-        ss << "   :  \n";
+        ss << "  Социальные льготы: нет комментария\n";
     }
 
     if (!scientificWorksComment.empty()) {
-        ss << "   : " << scientificWorksComment << "\n";
+        ss << "  Научные работы: " << scientificWorksComment << "\n";
     }
     else {
-        ss << "   :  \n";
+        ss << "  Научные работы: нет комментария\n";
     }
 
     if (!conferencesComment.empty()) {
-        ss << "    : " << conferencesComment << "\n";
+        ss << "  Участие в конференциях: " << conferencesComment << "\n";
     }
     else {
-        ss << "    :  \n";
+        ss << "  Участие в конференциях: нет комментария\n";
     }
 
     if (!communityActivityComment.empty()) {
-        ss << "   : " << communityActivityComment << "\n";
+        ss << "  Общественная активность: " << communityActivityComment << "\n";
     }
     else {
-        ss << "   :  \n";
+        ss << "  Общественная активность: нет комментария\n";
     }
 
     return ss.str();
@@ -2,18 +2,27 @@
 #define STUDENT_H
 
 #include "IUser.h"
+#include "StudentTable.h"
 #include <string>
+#include <cstdint>
 
 enum class StudyForm { Budget, Paid };
 
 class Student : public IUser {
+    friend class StudentTable;
+
+    // Пока студент присоединён к таблице, числовые поля, флаги и факультет
+    // хранятся в её строке row, а поля ниже не используются
+    StudentTable* table = nullptr;
+    uint32_t row = 0;
+
     std::string fio;
     double averageGrade;
     bool hasScholarship;
-    bool hasSocialBenefits;      //  
-    bool hasScientificWorks;     //    
-    int conferencesCount;        //   
-    bool isActiveInCommunity;    //  
+    bool hasSocialBenefits;      // НАЛИЧИЕ ЛЬГОТ
+    bool hasScientificWorks;     // НАЛИЧИЕ НАУЧНЫХ РАБОТ 
+    int conferencesCount;        // УЧАСТИЕ В КОНФЕРЕНЦИЯХ
+    bool isActiveInCommunity;    // ОБЩЕСТВЕННАЯ АКТИВНОСТЬ
 
     StudyForm studyForm;
     int course;
@@ -21,10 +30,10 @@ class Student : public IUser {
     std::string faculty;
     std::string specialty;
     std::string scholarshipType;
-    std::string socialBenefitsComment;    //   
-    std::string scientificWorksComment;   //    
-    std::string conferencesComment;       //     
-    std::string communityActivityComment; //    
+    std::string socialBenefitsComment;    // Комментарий к льготам
+    std::string scientificWorksComment;   // Комментарий к научным работам
+    std::string conferencesComment;       // Комментарий к участию в конференциях
+    std::string communityActivityComment; // Комментарий к общественной деятельности
 
 public:
     Student(const std::string& user, const std::string& hash,
@@ -38,59 +47,88 @@ public:
         const std::string& scientificWorksComment = "",
         const std::string& conferencesComment = "",
         const std::string& communityActivityComment = "");
-
-    std::string getRole() const override { return "student"; }
+    // Копия имела бы ту же строку таблицы
+    Student(const Student&) = delete;
+    Student& operator=(const Student&) = delete;
+    ~Student();
 
     std::string getFio() const { return fio; }
-    double getAverageGrade() const { return averageGrade; }
-    void setAverageGrade(double g) { averageGrade = g; }
-    bool getHasScholarship() const { return hasScholarship; }
-    void setHasScholarship(bool s) { hasScholarship = s; }
-    bool getHasSocialBenefits() const { return hasSocialBenefits; }
-    void setHasSocialBenefits(bool b) { hasSocialBenefits = b; }
-    bool getHasScientificWorks() const { return hasScientificWorks; }
-    void setHasScientificWorks(bool has) { hasScientificWorks = has; }
-    int getConferencesCount() const { return conferencesCount; }
-    void setConferencesCount(int count) { conferencesCount = count; }
-    bool getIsActiveInCommunity() const { return isActiveInCommunity; }
-    void setIsActiveInCommunity(bool active) { isActiveInCommunity = active; }
+    double getAverageGrade() const { return table ? table->grades[row] : averageGrade; }
+    void setAverageGrade(double g) { (table ? table->grades[row] : averageGrade) = g; markDirty(); }
+    bool getHasScholarship() const { return table ? table->scholarship[row] != 0 : hasScholarship; }
+    void setHasScholarship(bool s) {
+        if (table) table->scholarship[row] = s;
+        else hasScholarship = s;
+        markDirty();
+    }
+    bool getHasSocialBenefits() const { return table ? table->socialBenefits[row] != 0 : hasSocialBenefits; }
+    void setHasSocialBenefits(bool b) {
+        if (table) table->socialBenefits[row] = b;
+        else hasSocialBenefits = b;
+        markDirty();
+    }
+    bool getHasScientificWorks() const { return table ? table->scientificWorks[row] != 0 : hasScientificWorks; }
+    void setHasScientificWorks(bool has) {
+        if (table) table->scientificWorks[row] = has;
+        else hasScientificWorks = has;
+        markDirty();
+    }
+    int getConferencesCount() const { return table ? table->conferences[row] : conferencesCount; }
+    void setConferencesCount(int count) { (table ? table->conferences[row] : conferencesCount) = count; markDirty(); }
+    bool getIsActiveInCommunity() const { return table ? table->activeInCommunity[row] != 0 : isActiveInCommunity; }
+    void setIsActiveInCommunity(bool active) {
+        if (table) table->activeInCommunity[row] = active;
+        else isActiveInCommunity = active;
+        markDirty();
+    }
 
-    StudyForm getStudyForm() const { return studyForm; }
-    void setStudyForm(StudyForm form) { studyForm = form; }
-    int getCourse() const { return course; }
-    void setCourse(int c) { course = c; }
+    StudyForm getStudyForm() const {
+        if (!table) return studyForm;
+        return table->budget[row] ? StudyForm::Budget : StudyForm::Paid;
+    }
+    void setStudyForm(StudyForm form) {
+        if (table) table->budget[row] = (form == StudyForm::Budget);
+        else studyForm = form;
+        markDirty();
+    }
+    int getCourse() const { return table ? table->courses[row] : course; }
+    void setCourse(int c) { (table ? table->courses[row] : course) = c; markDirty(); }
     std::string getGroup() const { return group; }
-    void setGroup(const std::string& g) { group = g; }
-    std::string getFaculty() const { return faculty; }
-    void setFaculty(const std::string& f) { faculty = f; }
+    void setGroup(const std::string& g) { group = g; markDirty(); }
+    std::string getFaculty() const { return table ? table->faculties.str(table->facultyIds[row]) : faculty; }
+    void setFaculty(const std::string& f) {
+        if (table) table->facultyIds[row] = table->faculties.intern(f);
+        else faculty = f;
+        markDirty();
+    }
     std::string getSpecialty() const { return specialty; }
-    void setSpecialty(const std::string& s) { specialty = s; }
+    void setSpecialty(const std::string& s) { specialty = s; markDirty(); }
     std::string getScholarshipType() const { return scholarshipType; }
-    void setScholarshipType(const std::string& type) { scholarshipType = type; }
+    void setScholarshipType(const std::string& type) { scholarshipType = type; markDirty(); }
 
     std::string getSocialBenefitsComment() const { return socialBenefitsComment; }
-    void setSocialBenefitsComment(const std::string& comment) { socialBenefitsComment = comment; }
+    void setSocialBenefitsComment(const std::string& comment) { socialBenefitsComment = comment; markDirty(); }
 
     std::string getScientificWorksComment() const { return scientificWorksComment; }
-    void setScientificWorksComment(const std::string& comment) { scientificWorksComment = comment; }
+    void setScientificWorksComment(const std::string& comment) { scientificWorksComment = comment; markDirty(); }
 
     std::string getConferencesComment() const { return conferencesComment; }
-    void setConferencesComment(const std::string& comment) { conferencesComment = comment; }
+    void setConferencesComment(const std::string& comment) { conferencesComment = comment; markDirty(); }
 
     std::string getCommunityActivityComment() const { return communityActivityComment; }
-    void setCommunityActivityComment(const std::string& comment) { communityActivityComment = comment; }
-    void setFio(const std::string& f) { fio = f; }
+    void setCommunityActivityComment(const std::string& comment) { communityActivityComment = comment; markDirty(); }
+    void setFio(const std::string& f) { fio = f; markDirty(); }
 
     std::string getStudyFormString() const {
-        return (studyForm == StudyForm::Budget) ? "" : "";
+        return (getStudyForm() == StudyForm::Budget) ? "Бюджет" : "Платно";
     }
     bool hasEnoughConferences(int requiredCount) const {
-        return conferencesCount >= requiredCount;
+        return getConferencesCount() >= requiredCount;
     }
-    std::string getFullInfo() const;       //  
-    std::string getBasicInfo() const;      //  
-    std::string getAcademicInfo() const;   //  
-    std::string getCommentsInfo() const;   //   
+    std::string getFullInfo() const;       // Полная информация
+    std::string getBasicInfo() const;      // Базовая информация
+    std::string getAcademicInfo() const;   // Академическая информация
+    std::string getCommentsInfo() const;   // Информация о комментариях
 };
 
 #endif
\ No newline at end of file
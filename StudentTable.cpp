@@ -0,0 +1,116 @@
+#include "StudentTable.h"
+#include "Student.h"
+#include <algorithm>
+
+StudentTable::~StudentTable() {
+    clear();
+}
+
+void StudentTable::attach(Student& student) {
+    if (student.table) student.table->detach(student);
+
+    grades.push_back(student.averageGrade);
+    courses.push_back(student.course);
+    conferences.push_back(student.conferencesCount);
+    facultyIds.push_back(faculties.intern(student.faculty));
+    budget.push_back(student.studyForm == StudyForm::Budget);
+    scholarship.push_back(student.hasScholarship);
+    socialBenefits.push_back(student.hasSocialBenefits);
+    scientificWorks.push_back(student.hasScientificWorks);
+    activeInCommunity.push_back(student.isActiveInCommunity);
+
+    student.table = this;
+    student.row = static_cast<uint32_t>(owners.size());
+    owners.push_back(&student);
+}
+
+void StudentTable::detach(Student& student) {
+    if (student.table != this) return;
+    const uint32_t r = student.row;
+
+    student.averageGrade = grades[r];
+    student.course = courses[r];
+    student.conferencesCount = conferences[r];
+    student.faculty = faculties.str(facultyIds[r]);
+    student.studyForm = budget[r] ? StudyForm::Budget : StudyForm::Paid;
+    student.hasScholarship = scholarship[r] != 0;
+    student.hasSocialBenefits = socialBenefits[r] != 0;
+    student.hasScientificWorks = scientificWorks[r] != 0;
+    student.isActiveInCommunity = activeInCommunity[r] != 0;
+    student.table = nullptr;
+
+    grades.erase(grades.begin() + r);
+    courses.erase(courses.begin() + r);
+    conferences.erase(conferences.begin() + r);
+    facultyIds.erase(facultyIds.begin() + r);
+    budget.erase(budget.begin() + r);
+    scholarship.erase(scholarship.begin() + r);
+    socialBenefits.erase(socialBenefits.begin() + r);
+    scientificWorks.erase(scientificWorks.begin() + r);
+    activeInCommunity.erase(activeInCommunity.begin() + r);
+    owners.erase(owners.begin() + r);
+
+    for (size_t i = r; i < owners.size(); ++i) {
+        owners[i]->row = static_cast<uint32_t>(i);
+    }
+}
+
+void StudentTable::clear() {
+    // С конца, чтобы отсоединение не сдвигало оставшиеся строки
+    while (!owners.empty()) {
+        detach(*owners.back());
+    }
+    faculties.clear();
+}
+
+StudentTable::Summary StudentTable::summarize() const {
+    Summary s;
+    s.total = owners.size();
+    for (size_t i = 0; i < s.total; ++i) {
+        s.budget += budget[i];
+        s.scholarship += scholarship[i];
+    }
+    for (size_t i = 0; i < s.total; ++i) {
+        s.gradeSum += grades[i];
+    }
+    return s;
+}
+
+std::vector<size_t> StudentTable::courseHistogram(int maxCourse) const {
+    std::vector<size_t> histogram(maxCourse > 0 ? maxCourse : 0, 0);
+    const size_t n = courses.size();
+    for (size_t i = 0; i < n; ++i) {
+        const int32_t c = courses[i] - 1;
+        if (c >= 0 && c < maxCourse) histogram[c]++;
+    }
+    return histogram;
+}
+
+std::vector<StudentTable::FacultyStats> StudentTable::facultyStats() const {
+    // Накопление по идентификаторам словаря вместо поиска строк в map
+    std::vector<size_t> counts(faculties.size(), 0);
+    std::vector<double> sums(faculties.size(), 0.0);
+    const size_t n = facultyIds.size();
+    for (size_t i = 0; i < n; ++i) {
+        counts[facultyIds[i]]++;
+        sums[facultyIds[i]] += grades[i];
+    }
+
+    std::vector<FacultyStats> result;
+    for (uint32_t id = 0; id < counts.size(); ++id) {
+        if (counts[id] == 0) continue;
+        result.push_back({ faculties.str(id), counts[id], sums[id] });
+    }
+    std::sort(result.begin(), result.end(),
+        [](const FacultyStats& a, const FacultyStats& b) { return a.name < b.name; });
+    return result;
+}
+
+std::vector<uint32_t> StudentTable::scholarshipRows() const {
+    std::vector<uint32_t> rows;
+    const uint32_t n = static_cast<uint32_t>(scholarship.size());
+    for (uint32_t i = 0; i < n; ++i) {
+        if (scholarship[i]) rows.push_back(i);
+    }
+    return rows;
+}
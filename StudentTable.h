@@ -0,0 +1,68 @@
+#ifndef STUDENTTABLE_H
+#define STUDENTTABLE_H
+
+#include "StringDictionary.h"
+#include <vector>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+class Student;
+
+// Колоночная таблица студентов: каждое числовое поле и флаг хранится
+// в отдельном непрерывном массиве, факультет - идентификатором словаря.
+// Присоединённый объект Student читает и пишет свои поля через строку
+// таблицы, поэтому статистика считается простыми циклами по массивам.
+// Порядок строк совпадает с порядком присоединения (как в UserManager)
+class StudentTable {
+    friend class Student;
+
+    std::vector<double> grades;
+    std::vector<int32_t> courses;
+    std::vector<int32_t> conferences;
+    std::vector<uint32_t> facultyIds;
+    std::vector<uint8_t> budget;            // 1 - бюджет, 0 - платно
+    std::vector<uint8_t> scholarship;
+    std::vector<uint8_t> socialBenefits;
+    std::vector<uint8_t> scientificWorks;
+    std::vector<uint8_t> activeInCommunity;
+    std::vector<Student*> owners;           // строка -> объект-представление
+    StringDictionary faculties;
+
+public:
+    struct Summary {
+        size_t total = 0;
+        size_t budget = 0;
+        size_t scholarship = 0;
+        double gradeSum = 0.0;
+    };
+
+    struct FacultyStats {
+        std::string_view name;
+        size_t count = 0;
+        double gradeSum = 0.0;
+    };
+
+    StudentTable() = default;
+    StudentTable(const StudentTable&) = delete;
+    StudentTable& operator=(const StudentTable&) = delete;
+    ~StudentTable();
+
+    // Переносит поля студента в новую строку в конце таблицы
+    void attach(Student& student);
+    // Возвращает поля в объект и удаляет строку; строки ниже сдвигаются
+    void detach(Student& student);
+    void clear();
+
+    size_t size() const { return owners.size(); }
+
+    Summary summarize() const;
+    // Число студентов на курсах 1..maxCourse (индекс курс - 1)
+    std::vector<size_t> courseHistogram(int maxCourse) const;
+    // Только факультеты, на которых есть студенты, по возрастанию названия
+    std::vector<FacultyStats> facultyStats() const;
+    // Номера строк стипендиатов
+    std::vector<uint32_t> scholarshipRows() const;
+};
+
+#endif
@@ -1,188 +1,325 @@
 #include "UserManager.h"
 #include "FileManager.h"
+#include "Utils.h"
+#include "Logger.h"
 #include <sstream>
 #include <algorithm>
-#include <iostream>
+#include <chrono>
 
-UserManager::UserManager() {
-    std::cout << "===  UserManager ===" << std::endl;
-    std::cout << "   ..." << std::endl;
+UserManager::UserManager()
+    : usersFile("users.txt"), journalFile("users.journal"),
+    compactionThreshold(1000), journalCount(0) {
     loadUsers();
-    std::cout << " .  : " << users.size() << std::endl;
 }
 
-void UserManager::loadUsers() {
-    users.clear();
-    auto lines = FileManager::readLines("users.txt");
+UserManager::~UserManager() {
+    // Объекты могут пережить менеджер (например, в открытой сессии)
+    for (const auto& user : users) {
+        user->dirtyList = nullptr;
+    }
+}
 
-    std::cout << "DEBUG:    : " << lines.size() << std::endl;
+void UserManager::clearDirtyUsers() {
+    for (IUser* user : dirtyUsers) {
+        user->clearDirty();
+    }
+    dirtyUsers.clear();
+}
 
-    for (size_t i = 0; i < lines.size(); ++i) {
-        const auto& line = lines[i];
+void UserManager::loadUsers() {
+    auto started = std::chrono::steady_clock::now();
+    size_t skipped = 0;
 
-        if (line.empty()) {
-            std::cout << "DEBUG:  " << i << " , " << std::endl;
-            continue;
+    for (const auto& user : users) {
+        user->dirtyList = nullptr;
+    }
+    dirtyUsers.clear();
+    users.clear();
+    usersByName.clear();
+    studentTable.clear();
+    students.clear();
+    removedUsers.clear();
+
+    // Строки берутся из отображённого в память файла, поля - string_view
+    // в эти строки; буфер полей переиспользуется между строками
+    MappedLines lines = FileManager::mapLines(usersFile);
+    std::vector<std::string> journal = FileManager::readJournal(journalFile);
+    std::vector<std::string_view> fields;
+
+    // Записи журнала заменяют строку с тем же логином, новые логины
+    // добавляются в конец, "deleted,логин" убирает строку
+    std::vector<std::string_view> records(lines.getLines().begin(), lines.getLines().end());
+    if (!journal.empty()) {
+        std::unordered_map<std::string_view, size_t> positions;
+        for (size_t i = 0; i < records.size(); ++i) {
+            FileManager::splitFields(records[i], ',', fields);
+            if (fields.size() >= 2) positions.emplace(fields[1], i);
         }
+        for (size_t i = 0; i < journal.size(); ++i) {
+            FileManager::splitFields(journal[i], ',', fields);
+            if (fields.size() < 2) {
+                LOG_WARN("UserManager", journalFile << ", строка " << (i + 1)
+                    << ": нет логина, запись пропущена");
+                continue;
+            }
+            auto found = positions.find(fields[1]);
+            if (fields[0] == DELETED_TAG) {
+                if (found != positions.end()) {
+                    records[found->second] = std::string_view();
+                    positions.erase(found);
+                }
+            }
+            else if (found != positions.end()) {
+                records[found->second] = journal[i];
+            }
+            else {
+                positions.emplace(fields[1], records.size());
+                records.push_back(journal[i]);
+            }
+        }
+    }
 
-        std::cout << "DEBUG:   " << i << ": " << line.substr(0, 50) << "..." << std::endl;
-
-        std::vector<std::string> fields;
-        std::stringstream ss(line);
-        std::string field;
+    for (size_t i = 0; i < records.size(); ++i) {
+        std::string_view line = records[i];
+        if (line.empty()) continue;
 
-        while (std::getline(ss, field, ',')) {
-            fields.push_back(field);
-        }
+        FileManager::splitFields(line, ',', fields);
 
-        std::cout << "DEBUG:   : " << fields.size() << std::endl;
+        LOG_DEBUG("UserManager", "Запись " << (i + 1) << ": полей=" << fields.size()
+            << " начало=" << line.substr(0, 50));
 
         if (fields.size() < 3) {
-            std::cout << "DEBUG:    (< 3), " << std::endl;
+            LOG_WARN("UserManager", "Запись " << (i + 1)
+                << ": слишком мало полей (" << fields.size() << "), пропущена");
+            ++skipped;
             continue;
         }
 
-        std::string role = fields[0];
-        std::string username = fields[1];
-        std::string passwordHash = fields[2];
-
-        std::cout << "DEBUG: : " << role << ", : " << username << std::endl;
+        std::string_view role = fields[0];
+        std::string username(fields[1]);
+        std::string passwordHash(fields[2]);
 
         if (role == "student") {
             if (fields.size() < 16) {  
-                std::cout << "DEBUG:   " << username
-                    << "   (" << fields.size()
-                    << "   16), " << std::endl;
+                LOG_WARN("UserManager", "Запись " << (i + 1) << ": у студента " << username
+                    << " недостаточно полей (" << fields.size() << " вместо минимум 16), пропущен");
+                ++skipped;
                 continue;
             }
 
-            try {
-                std::string fio = fields[3];
-
-                double avg = 0.0;
-                if (!fields[4].empty()) avg = std::stod(fields[4]);
-
-                bool hasScholarship = (fields.size() > 5 && fields[5] == "1");
-                bool hasSocialBenefits = (fields.size() > 6 && fields[6] == "1");
-                bool hasScientificWorks = (fields.size() > 7 && fields[7] == "1");
+            auto field = [&fields](size_t index) {
+                return index < fields.size() ? fields[index] : std::string_view();
+            };
 
-                int conferences = 0;
-                if (fields.size() > 8 && !fields[8].empty())
-                    conferences = std::stoi(fields[8]);
-
-                bool isActiveInCommunity = (fields.size() > 9 && fields[9] == "1");
-                StudyForm studyForm = (fields.size() > 10 && fields[10] == "1") ? StudyForm::Paid : StudyForm::Budget;
-
-                int course = 1;
-                if (fields.size() > 11 && !fields[11].empty())
-                    course = std::stoi(fields[11]);
-                if (course < 1 || course > 4) course = 1;
-
-                std::string group = (fields.size() > 12) ? fields[12] : "";
-                std::string faculty = (fields.size() > 13) ? fields[13] : "";
-                std::string specialty = (fields.size() > 14) ? fields[14] : "";
-                std::string scholarshipType = (fields.size() > 15) ? fields[15] : "";
+            double avg = 0.0;
+            if (!field(4).empty() && !Utils::parseDouble(field(4), avg)) {
+                LOG_WARN("UserManager", "Запись " << (i + 1) << ": студент " << username
+                    << ": некорректный средний балл, пропущен");
+                ++skipped;
+                continue;
+            }
 
-                std::string socialComment = (fields.size() > 16) ? fields[16] : "";
-                std::string scientificComment = (fields.size() > 17) ? fields[17] : "";
-                std::string conferencesComment = (fields.size() > 18) ? fields[18] : "";
-                std::string activityComment = (fields.size() > 19) ? fields[19] : "";
+            bool hasScholarship = field(5) == "1";
+            bool hasSocialBenefits = field(6) == "1";
+            bool hasScientificWorks = field(7) == "1";
 
-                auto student = std::make_shared<Student>(
-                    username, passwordHash, fio, avg, hasScholarship,
-                    hasSocialBenefits, hasScientificWorks, conferences,
-                    isActiveInCommunity, studyForm, course, group,
-                    faculty, specialty, scholarshipType,
-                    socialComment, scientificComment, conferencesComment, activityComment
-                );
+            int conferences = 0;
+            if (!field(8).empty() && !Utils::parseInt(field(8), conferences)) {
+                LOG_WARN("UserManager", "Запись " << (i + 1) << ": студент " << username
+                    << ": некорректное число конференций, пропущен");
+                ++skipped;
+                continue;
+            }
 
-                users.push_back(student);
-                std::cout << "  : " << fio
-                    << " (: " << username << ")" << std::endl;
+            bool isActiveInCommunity = field(9) == "1";
+            StudyForm studyForm = field(10) == "1" ? StudyForm::Paid : StudyForm::Budget;
 
+            int course = 1;
+            if (!field(11).empty() && !Utils::parseInt(field(11), course)) {
+                LOG_WARN("UserManager", "Запись " << (i + 1) << ": студент " << username
+                    << ": некорректный курс, пропущен");
+                ++skipped;
+                continue;
             }
-            catch (const std::exception& e) {
-                std::cout << "    " << username
-                    << ": " << e.what() << std::endl;
+            if (course < 1 || course > 4) course = 1;
+
+            std::string fio(field(3));
+            auto student = std::make_shared<Student>(
+                username, passwordHash, fio, avg, hasScholarship,
+                hasSocialBenefits, hasScientificWorks, conferences,
+                isActiveInCommunity, studyForm, course,
+                std::string(field(12)), std::string(field(13)),
+                std::string(field(14)), std::string(field(15)),
+                std::string(field(16)), std::string(field(17)),
+                std::string(field(18)), std::string(field(19))
+            );
+
+            if (!addUser(student)) {
+                LOG_WARN("UserManager", "Запись " << (i + 1)
+                    << ": повторяющийся логин " << username << ", запись пропущена");
+                ++skipped;
+                continue;
             }
+            LOG_DEBUG("UserManager", "Загружен студент " << username);
         }
         else if (role == "admin") {
             auto admin = std::make_shared<Admin>(username, passwordHash);
-            users.push_back(admin);
-            std::cout << " : " << username << std::endl;
+            if (!addUser(admin)) {
+                LOG_WARN("UserManager", "Запись " << (i + 1)
+                    << ": повторяющийся логин " << username << ", запись пропущена");
+                ++skipped;
+                continue;
+            }
+            LOG_DEBUG("UserManager", "Загружен администратор " << username);
         }
     }
 
-    std::cout << " .  : " << users.size() << std::endl;
+    // Загруженное уже записано на диск
+    clearDirtyUsers();
+    journalCount = journal.size();
+    if (journalCount >= compactionThreshold) {
+        compact();
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+    LOG_INFO("UserManager", "Пользователи загружены: users=" << users.size()
+        << " students=" << students.size() << " admins=" << (users.size() - students.size())
+        << " skipped=" << skipped << " lines=" << lines.size()
+        << " journal=" << journal.size() << " ms=" << ms);
 }
 
-void UserManager::saveUsers() const {
-   
+std::string UserManager::formatUser(const IUser& user) {
+    std::stringstream ss;
+
+    if (user.isStudent()) {
+        const Student* stu = static_cast<const Student*>(&user);
+
+        ss << "student,"
+            << stu->getUsername() << ","
+            << stu->getPasswordHash() << ","
+            << stu->getFio() << ","
+            << stu->getAverageGrade() << ","
+            << (stu->getHasScholarship() ? "1" : "0") << ","
+            << (stu->getHasSocialBenefits() ? "1" : "0") << ","
+            << (stu->getHasScientificWorks() ? "1" : "0") << ","
+            << stu->getConferencesCount() << ","
+            << (stu->getIsActiveInCommunity() ? "1" : "0") << ","
+            << (stu->getStudyForm() == StudyForm::Budget ? "0" : "1") << ","
+            << stu->getCourse() << ","
+            << stu->getGroup() << ","
+            << stu->getFaculty() << ","
+            << stu->getSpecialty() << ","
+            << stu->getScholarshipType() << ","
+            << stu->getSocialBenefitsComment() << ","
+            << stu->getScientificWorksComment() << ","
+            << stu->getConferencesComment() << ","
+            << stu->getCommunityActivityComment();
+    }
+    else {
+        ss << "admin," << user.getUsername() << "," << user.getPasswordHash();
+    }
 
-    std::vector<std::string> lines;
+    return ss.str();
+}
 
-    for (const auto& user : users) {
-        
-
-        std::stringstream ss;
-
-        if (user->getRole() == "student") {
-            auto stu = std::static_pointer_cast<Student>(user);
-
-            ss << "student,"
-                << stu->getUsername() << ","
-                << stu->getPasswordHash() << ","
-                << stu->getFio() << ","
-                << stu->getAverageGrade() << ","
-                << (stu->getHasScholarship() ? "1" : "0") << ","
-                << (stu->getHasSocialBenefits() ? "1" : "0") << ","
-                << (stu->getHasScientificWorks() ? "1" : "0") << ","
-                << stu->getConferencesCount() << ","
-                << (stu->getIsActiveInCommunity() ? "1" : "0") << ","
-                << (stu->getStudyForm() == StudyForm::Budget ? "0" : "1") << ","
-                << stu->getCourse() << ","
-                << stu->getGroup() << ","
-                << stu->getFaculty() << ","
-                << stu->getSpecialty() << ","
-                << stu->getScholarshipType() << ","
-                << stu->getSocialBenefitsComment() << ","
-                << stu->getScientificWorksComment() << ","
-                << stu->getConferencesComment() << ","
-                << stu->getCommunityActivityComment();
-        }
-        else {
-            ss << "admin," << user->getUsername() << "," << user->getPasswordHash();
-        }
+void UserManager::saveUsers() {
+    auto started = std::chrono::steady_clock::now();
 
-        lines.push_back(ss.str());
-       
+    // В журнал пишутся только удаления и изменённые записи; сначала
+    // удаления, чтобы повторно созданный логин не удалился при чтении
+    std::vector<std::string> lines;
+    for (const auto& username : removedUsers) {
+        lines.push_back(std::string(DELETED_TAG) + "," + username);
     }
+    for (const IUser* user : dirtyUsers) {
+        lines.push_back(formatUser(*user));
+    }
+    if (lines.empty()) return;
 
-    FileManager::writeLines("users.txt", lines);
-    std::cout << "===   ===" << std::endl;
+    if (journalCount + lines.size() >= compactionThreshold) {
+        compact();
+        return;
+    }
+
+    // При ошибке отметки не сбрасываются и запись повторится при следующем сохранении
+    if (!FileManager::appendLines(journalFile, lines, true)) {
+        LOG_ERROR("UserManager", "Не удалось дописать " << journalFile
+            << ": records=" << lines.size());
+        return;
+    }
+    clearDirtyUsers();
+    removedUsers.clear();
+    journalCount += lines.size();
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+    LOG_INFO("UserManager", "Пользователи сохранены в журнал: records=" << lines.size()
+        << " journal=" << journalCount << " ms=" << ms);
 }
 
-std::shared_ptr<IUser> UserManager::findUser(const std::string& username) const {
+void UserManager::compact() {
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::string> lines;
+    lines.reserve(users.size());
     for (const auto& user : users) {
-        if (user->getUsername() == username) return user;
+        lines.push_back(formatUser(*user));
+    }
+
+    // Сначала снимок, затем удаление журнала: при сбое между шагами журнал
+    // применится к новому снимку повторно, что ничего не меняет
+    if (!FileManager::writeLines(usersFile, lines)) {
+        LOG_ERROR("UserManager", "Не удалось сохранить " << usersFile << ": users=" << users.size());
+        return;
     }
-    return nullptr;
+    FileManager::removeFile(journalFile);
+    clearDirtyUsers();
+    removedUsers.clear();
+    journalCount = 0;
+
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+    LOG_INFO("UserManager", "Пользователи сохранены: users=" << users.size() << " ms=" << ms);
+}
+
+std::shared_ptr<IUser> UserManager::findUser(std::string_view username) const {
+    auto it = usersByName.find(username);
+    return it != usersByName.end() ? it->second : nullptr;
 }
 
 bool UserManager::addUser(std::shared_ptr<IUser> user) {
-    if (findUser(user->getUsername())) return false;
-    users.push_back(user);
+    // Ключ - view на логин внутри объекта, который живёт, пока он в индексе
+    if (!usersByName.emplace(user->getUsername(), user).second) return false;
+    user->dirtyList = &dirtyUsers;
+    if (user->isDirty()) dirtyUsers.push_back(user.get());
+    if (user->isStudent()) {
+        students.push_back(std::static_pointer_cast<Student>(user));
+        studentTable.attach(*students.back());
+    }
+    users.push_back(std::move(user));
     return true;
 }
 
 bool UserManager::removeUser(const std::string& username) {
-    for (auto it = users.begin(); it != users.end(); ++it) {
-        if ((*it)->getUsername() == username) {
-            users.erase(it);
-            return true;
-        }
+    auto found = usersByName.find(username);
+    if (found == usersByName.end()) return false;
+
+    // Порядок в users сохраняется: он определяет порядок строк в users.txt
+    IUser* user = found->second.get();
+    user->dirtyList = nullptr;
+    if (user->isDirty()) {
+        dirtyUsers.erase(std::find(dirtyUsers.begin(), dirtyUsers.end(), user));
+    }
+    users.erase(std::find(users.begin(), users.end(), found->second));
+    if (user->isStudent()) {
+        auto it = std::find_if(students.begin(), students.end(),
+            [user](const std::shared_ptr<Student>& s) { return s.get() == user; });
+        studentTable.detach(**it);
+        students.erase(it);
     }
-    return false;
+    removedUsers.push_back(found->second->getUsername());
+    usersByName.erase(found);
+    return true;
 }
 
 bool UserManager::updateUserPassword(const std::string& username, const std::string& newHash) {
@@ -191,13 +328,3 @@ bool UserManager::updateUserPassword(const std::string& username, const std::str
     u->setPasswordHash(newHash);
     return true;
 }
-
-std::vector<std::shared_ptr<Student>> UserManager::getAllStudents() const {
-    std::vector<std::shared_ptr<Student>> result;
-    for (const auto& user : users) {
-        if (user->getRole() == "student") {
-            result.push_back(std::static_pointer_cast<Student>(user));
-        }
-    }
-    return result;
-}
\ No newline at end of file
@@ -4,24 +4,66 @@
 #include "IUser.h"
 #include "Student.h"
 #include "Admin.h"
+#include "StudentTable.h"
 #include <vector>
 #include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <string>
 
 class UserManager {
     std::vector<std::shared_ptr<IUser>> users;
+    // Индекс логин -> пользователь; ключи указывают на строки логинов внутри
+    // объектов пользователей, поэтому поиск по string_view не копирует строку
+    std::unordered_map<std::string_view, std::shared_ptr<IUser>> usersByName;
+    // Студенты отдельно, в том же порядке, что и в users: приведение типа
+    // выполняется один раз при добавлении
+    std::vector<std::shared_ptr<Student>> students;
+    // Колонки полей студентов; строка i соответствует students[i].
+    // Объявлена после students и разрушается раньше них
+    StudentTable studentTable;
+
+    // users.txt - снимок, users.journal - записи, изменённые после него.
+    // Сохранение дописывает в журнал только изменённые записи; когда журнал
+    // набирает compactionThreshold записей, снимок переписывается целиком
+    std::string usersFile;
+    std::string journalFile;
+    size_t compactionThreshold;
+    size_t journalCount;
+    std::vector<std::string> removedUsers;   // логины, удалённые после сохранения
+    // Пользователи с флагом dirty, без повторов: объект добавляет себя сам
+    // (IUser::markDirty), поэтому сохранение не перебирает всех пользователей
+    std::vector<IUser*> dirtyUsers;
+
+    void clearDirtyUsers();
+
+    static constexpr const char* DELETED_TAG = "deleted";
+
+    static std::string formatUser(const IUser& user);
 
 public:
     UserManager();
+    ~UserManager();
+
+    UserManager(const UserManager&) = delete;
+    UserManager& operator=(const UserManager&) = delete;
+
     void loadUsers();
-    void saveUsers() const;
+    // Записывает изменения с прошлого сохранения
+    void saveUsers();
+    // Переписывает users.txt целиком и очищает журнал
+    void compact();
+    void setCompactionThreshold(size_t threshold) { compactionThreshold = threshold; }
 
-    std::shared_ptr<IUser> findUser(const std::string& username) const;
+    std::shared_ptr<IUser> findUser(std::string_view username) const;
     bool addUser(std::shared_ptr<IUser> user);
     bool removeUser(const std::string& username);
     bool updateUserPassword(const std::string& username, const std::string& newHash);
 
-    std::vector<std::shared_ptr<Student>> getAllStudents() const;
-    std::vector<std::shared_ptr<IUser>> getAllUsers() const { return users; }
+    // Ссылки действительны до следующего изменения списка пользователей
+    const std::vector<std::shared_ptr<Student>>& getAllStudents() const { return students; }
+    const std::vector<std::shared_ptr<IUser>>& getAllUsers() const { return users; }
+    const StudentTable& getStudentTable() const { return studentTable; }
 };
 
 #endif 
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <functional>
 #include <random>
 #include <cctype>
+#include <charconv>
 
 namespace Utils {
     std::string generateSalt() {
@@ -31,7 +32,7 @@ namespace Utils {
         std::hash<std::string> hasher;
         size_t hash1 = hasher(saltedPassword);
 
-        //  
+        // Двойное хэширование
         std::string hashStr = std::to_string(hash1) + salt;
         size_t hash2 = hasher(hashStr);
 
@@ -41,24 +42,45 @@ namespace Utils {
     }
 
     std::string toLower(const std::string& s) {
-        std::string r = s;
-        std::transform(r.begin(), r.end(), r.begin(), ::tolower);
+        return toLowerCP1251(s);
+    }
+
+    char toLowerCP1251(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (u >= 'A' && u <= 'Z') return static_cast<char>(u + ('a' - 'A'));
+        if (u >= 0xC0 && u <= 0xDF) return static_cast<char>(u + 0x20);   // А-Я
+        switch (u) {
+        case 0xA8: return static_cast<char>(0xB8);   // Ё
+        case 0xA1: return static_cast<char>(0xA2);   // Ў
+        case 0xB2: return static_cast<char>(0xB3);   // І
+        case 0xAA: return static_cast<char>(0xBA);   // Є
+        case 0xAF: return static_cast<char>(0xBF);   // Ї
+        case 0xA5: return static_cast<char>(0xB4);   // Ґ
+        default: return c;
+        }
+    }
+
+    std::string toLowerCP1251(std::string_view s) {
+        std::string r(s);
+        for (char& c : r) {
+            c = toLowerCP1251(c);
+        }
         return r;
     }
 
     std::string statusToString(int status) {
         switch (status) {
-        case 0: return "";
-        case 1: return "";
-        case 2: return "";
-        default: return "";
+        case 0: return "Ожидание";
+        case 1: return "Одобрено";
+        case 2: return "Отклонено";
+        default: return "Неизвестно";
         }
     }
 
     int stringToStatus(const std::string& s) {
-        if (s == "Pending" || s == "") return 0;
-        if (s == "Approved" || s == "") return 1;
-        if (s == "Rejected" || s == "") return 2;
+        if (s == "Pending" || s == "Ожидание") return 0;
+        if (s == "Approved" || s == "Одобрено") return 1;
+        if (s == "Rejected" || s == "Отклонено") return 2;
         return 0;
     }
 
@@ -106,4 +128,78 @@ namespace Utils {
         }
         return result;
     }
+
+    // Коды Unicode для символов 0x80-0xBF кодировки Windows-1251
+    // (0xC0-0xFF - подряд идущие А-я, U+0410-U+044F)
+    static const unsigned short CP1251_HIGH[64] = {
+        0x0402, 0x0403, 0x201A, 0x0453, 0x201E, 0x2026, 0x2020, 0x2021,
+        0x20AC, 0x2030, 0x0409, 0x2039, 0x040A, 0x040C, 0x040B, 0x040F,
+        0x0452, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+        0xFFFD, 0x2122, 0x0459, 0x203A, 0x045A, 0x045C, 0x045B, 0x045F,
+        0x00A0, 0x040E, 0x045E, 0x0408, 0x00A4, 0x0490, 0x00A6, 0x00A7,
+        0x0401, 0x00A9, 0x0404, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x0407,
+        0x00B0, 0x00B1, 0x0406, 0x0456, 0x0491, 0x00B5, 0x00B6, 0x00B7,
+        0x0451, 0x2116, 0x0454, 0x00BB, 0x0458, 0x0405, 0x0455, 0x0457
+    };
+
+    std::string escapeJSON(std::string_view field) {
+        static const char hex[] = "0123456789abcdef";
+
+        std::string result;
+        result.reserve(field.size() * 2 + 2);
+        result += '"';
+        for (char ch : field) {
+            unsigned char c = static_cast<unsigned char>(ch);
+            if (c == '"' || c == '\\') {
+                result += '\\';
+                result += ch;
+            }
+            else if (c == '\n') {
+                result += "\\n";
+            }
+            else if (c == '\r') {
+                result += "\\r";
+            }
+            else if (c == '\t') {
+                result += "\\t";
+            }
+            else if (c < 0x20) {
+                result += "\\u00";
+                result += hex[c >> 4];
+                result += hex[c & 0x0F];
+            }
+            else if (c < 0x80) {
+                result += ch;
+            }
+            else {
+                unsigned int code = c >= 0xC0 ? 0x0410 + (c - 0xC0) : CP1251_HIGH[c - 0x80];
+                if (code < 0x800) {
+                    result += static_cast<char>(0xC0 | (code >> 6));
+                    result += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else {
+                    result += static_cast<char>(0xE0 | (code >> 12));
+                    result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    result += static_cast<char>(0x80 | (code & 0x3F));
+                }
+            }
+        }
+        result += '"';
+        return result;
+    }
+
+    bool parseInt(std::string_view s, int& value) {
+        auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+        return res.ec == std::errc() && res.ptr == s.data() + s.size();
+    }
+
+    bool parseInt64(std::string_view s, long long& value) {
+        auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+        return res.ec == std::errc() && res.ptr == s.data() + s.size();
+    }
+
+    bool parseDouble(std::string_view s, double& value) {
+        auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+        return res.ec == std::errc() && res.ptr == s.data() + s.size();
+    }
 }
\ No newline at end of file
@@ -2,18 +2,30 @@
 #define UTILS_H
 
 #include <string>
+#include <string_view>
 
 namespace Utils {
     std::string hashPassword(const std::string& password);
     std::string toLower(const std::string& s);
+    // Нижний регистр для латиницы и кириллицы в кодировке Windows-1251
+    char toLowerCP1251(char c);
+    std::string toLowerCP1251(std::string_view s);
     std::string statusToString(int status);
     int stringToStatus(const std::string& s);
     long long currentTimeSeconds();
 
     std::string escapeCSV(const std::string& field);
     std::string unescapeCSV(const std::string& field);
+    // Строковый литерал JSON в кавычках: текст из Windows-1251 переводится в UTF-8
+    std::string escapeJSON(std::string_view field);
 
-    //    
+    // Разбор чисел без выделения памяти и без зависимости от локали;
+    // поле должно целиком состоять из числа
+    bool parseInt(std::string_view s, int& value);
+    bool parseInt64(std::string_view s, long long& value);
+    bool parseDouble(std::string_view s, double& value);
+
+    // Константы для проверки баллов
     static constexpr double MIN_GRADE = 0.0;
     static constexpr double MAX_GRADE = 10.0;
 
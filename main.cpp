@@ -8,10 +8,12 @@
 #include <windows.h>
 #include <locale>
 #include <iomanip>
+#include <sstream>
 #include <optional> 
 #include <stdexcept>
 #include <map>
 #include <set>
+#include "Logger.h"
 #include "UserManager.h"
 #include "ScholarshipTypeManager.h"
 #include "ScholarshipType.h"        
@@ -23,9 +25,12 @@
 #include "Admin.h"
 #include "Application.h"
 #include "ApplicationHistory.h"
+#include "HistoryExporter.h"
 #include <fstream>
 #include <ctime>
 #include "InputValidation.h"
+#include "SessionServer.h"
+#include "LoadGenerator.h"
 
 using namespace std;
 
@@ -37,6 +42,8 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
 void studentManagementMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipManager,
     ApplicationManager& appManager);
 void viewApplicationHistory(const ApplicationHistory& history, UserManager& userManager);
+int runServerMode(int argc, char* argv[]);
+int runLoadGenerator(int argc, char* argv[]);
 
 void printStudentInfo(const std::shared_ptr<Student>& student,
     const ApplicationManager& appManager,
@@ -79,7 +86,7 @@ void handleLogin(UserManager& userManager, ScholarshipTypeManager& scholarshipMa
             return;
         }
 
-        if (user->getRole() == "student") {
+        if (user->isStudent()) {
             InputUtils::printSuccess("Добро пожаловать, " + username + "!");
             InputUtils::waitForEnter("Нажмите Enter для продолжения...");
 
@@ -402,12 +409,26 @@ void handleExit(UserManager& userManager, ApplicationManager& appManager,
 
         SafeExecutor::executeWithRetry([&appManager]() {
             appManager.saveApplications();
+            // Заявки и журнал истории пишутся фоновым потоком - дожидаемся диска
+            if (!appManager.flush()) {
+                throw std::runtime_error("не все изменения записаны на диск");
+            }
             }, "сохранения заявок");
 
         SafeExecutor::executeWithRetry([&scholarshipManager]() {
             scholarshipManager.saveScholarshipTypes();
             }, "сохранения типов стипендий");
 
+        WriterMetrics metrics = appManager.getWriterMetrics();
+        std::ostringstream writerInfo;
+        writerInfo << std::fixed << std::setprecision(1)
+            << "Фоновая запись: операций " << metrics.completed
+            << ", объединено " << metrics.coalesced
+            << ", наибольшая очередь " << metrics.maxQueueDepth
+            << ", наибольшая запись " << metrics.maxWriteMs << " мс"
+            << ", сброс при выходе " << metrics.lastFlushMs << " мс";
+        InputUtils::printInfo(writerInfo.str());
+
         InputUtils::printSuccess("Все данные успешно сохранены!");
         InputUtils::printSuccess("Спасибо за использование системы!");
 
@@ -1550,7 +1571,7 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
                         return;
                     }
 
-                    std::vector<Application> sortedApps = apps;
+                    std::vector<Application> sortedApps(apps.begin(), apps.end());
                     std::sort(sortedApps.begin(), sortedApps.end(),
                         [](const Application& a, const Application& b) {
                             return a.getAverageGrade() > b.getAverageGrade();
@@ -1576,7 +1597,7 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
                         return;
                     }
 
-                    Application* appPtr = appManager.getApplicationById(appId);
+                    const Application* appPtr = appManager.getApplicationById(appId);
                     if (!appPtr) {
                         throw std::runtime_error("Заявка с ID " + std::to_string(appId) + " не найдена.");
                     }
@@ -1665,7 +1686,7 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
                             "ID должен быть положительным числом"
                         );
 
-                        Application* app = appManager.getApplicationById(appId);
+                        const Application* app = appManager.getApplicationById(appId);
 
                         if (!app) {
                             throw std::runtime_error("Заявка с ID " + std::to_string(appId) + " не найдена.");
@@ -1702,7 +1723,7 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
 
                         auto student = userManager.findUser(username);
 
-                        if (!student || student->getRole() != "student") {
+                        if (!student || !student->isStudent()) {
                             throw std::runtime_error("Студент с таким логином не найден.");
                         }
 
@@ -1868,7 +1889,7 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
                             throw std::runtime_error("Пользователь не найден.");
                         }
 
-                        if (user->getRole() == "admin") {
+                        if (user->getRoleType() == UserRole::Admin) {
                             throw std::runtime_error("Нельзя удалить администратора!");
                         }
 
@@ -1882,7 +1903,7 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
                         }
 
                         if (userManager.removeUser(username)) {
-                            if (user->getRole() == "student") {
+                            if (user->isStudent()) {
                                 appManager.removeApplicationsByStudent(username);
                                 appManager.saveApplications();
                             }
@@ -1897,7 +1918,7 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
 
                     case 4: {  
                         InputUtils::printHeader("Все пользователи");
-                        auto users = userManager.getAllUsers();
+                        const auto& users = userManager.getAllUsers();
 
                         if (users.empty()) {
                             InputUtils::printInfo("Нет пользователей в системе.");
@@ -1910,7 +1931,7 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
                             for (const auto& user : users) {
                                 std::cout << "Логин: " << user->getUsername()
                                     << " | Роль: " << user->getRole() << "\n";
-                                if (user->getRole() == "student") studentCount++;
+                                if (user->isStudent()) studentCount++;
                                 else adminCount++;
                             }
                             InputUtils::printDivider();
@@ -2029,6 +2050,30 @@ void adminMenu(UserManager& userManager, ScholarshipTypeManager& scholarshipMana
     }
 }
 
+// Постраничный вывод истории по фильтру: страница за страницей, от новых записей
+static void printHistoryPages(const ApplicationHistory& history, const HistoryFilter& filter) {
+    const size_t pageSize = 20;
+    HistoryCursor cursor;
+    int pageNumber = 1;
+
+    while (true) {
+        HistoryPage page = history.query(filter).after(cursor).limit(pageSize).fetch();
+
+        std::cout << "Страница " << pageNumber << ":\n";
+        InputUtils::printDivider();
+        for (const auto& record : page.records) {
+            std::cout << record.toString() << "\n";
+            InputUtils::printDivider();
+        }
+
+        if (!page.hasMore || !InputValidator::getYesNoInput("Показать следующую страницу?")) {
+            break;
+        }
+        cursor = page.next;
+        pageNumber++;
+    }
+}
+
 //ПРОСМОТР ИСТОРИИ ЗАЯВОК=
 void viewApplicationHistory(const ApplicationHistory& history, UserManager& userManager) {
     while (true) {
@@ -2043,34 +2088,29 @@ void viewApplicationHistory(const ApplicationHistory& history, UserManager& user
                 "Общий поиск",
                 "Статистика",
                 "Экспорт истории в файл",
+                "Аналитика по периодам",
                 "Назад"
             };
 
             int choice = InputValidator::getMenuChoice(
                 "ИСТОРИЯ ЗАЯВОК НА СТИПЕНДИИ",
                 options,
-                [](int val) { return val >= 1 && val <= 10; },
-                "Действие должно быть от 1 до 10"
+                [](int val) { return val >= 1 && val <= 11; },
+                "Действие должно быть от 1 до 11"
             );
 
-            if (choice == 10) break;
+            if (choice == 11) break;
 
             switch (choice) {
             case 1: {  
                 InputUtils::printHeader("ВСЯ ИСТОРИЯ ЗАЯВОК");
-                auto allRecords = history.getAllRecords();
 
-                if (allRecords.empty()) {
+                if (history.getTotalCount() == 0) {
                     InputUtils::printInfo("История пуста.");
                 }
                 else {
-                    std::cout << "Всего записей: " << allRecords.size() << "\n";
-                    InputUtils::printDivider();
-
-                    for (const auto& record : allRecords) {
-                        std::cout << record.toString() << "\n";
-                        InputUtils::printDivider();
-                    }
+                    std::cout << "Всего записей: " << history.getTotalCount() << "\n";
+                    printHistoryPages(history, HistoryFilter());
 
                     std::cout << "\nСТАТИСТИКА:\n";
                     std::cout << "  Создано: " << history.getActionCount(HistoryAction::CREATED) << "\n";
@@ -2084,19 +2124,14 @@ void viewApplicationHistory(const ApplicationHistory& history, UserManager& user
 
             case 2: {  
                 InputUtils::printHeader("ОДОБРЕННЫЕ ЗАЯВКИ");
-                auto approved = history.getRecordsByAction(HistoryAction::APPROVED);
+                int approved = history.getActionCount(HistoryAction::APPROVED);
 
-                if (approved.empty()) {
+                if (approved == 0) {
                     InputUtils::printInfo("Нет одобренных заявок в истории.");
                 }
                 else {
-                    std::cout << "Всего одобрено: " << approved.size() << "\n";
-                    InputUtils::printDivider();
-
-                    for (const auto& record : approved) {
-                        std::cout << record.toString() << "\n";
-                        InputUtils::printDivider();
-                    }
+                    std::cout << "Всего одобрено: " << approved << "\n";
+                    printHistoryPages(history, HistoryFilter().withAction(HistoryAction::APPROVED));
                 }
                 InputUtils::waitForEnter("Нажмите Enter для продолжения...");
                 break;
@@ -2104,19 +2139,14 @@ void viewApplicationHistory(const ApplicationHistory& history, UserManager& user
 
             case 3: {  
                 InputUtils::printHeader("ОТКЛОНЕННЫЕ ЗАЯВКИ");
-                auto rejected = history.getRecordsByAction(HistoryAction::REJECTED);
+                int rejected = history.getActionCount(HistoryAction::REJECTED);
 
-                if (rejected.empty()) {
+                if (rejected == 0) {
                     InputUtils::printInfo("Нет отклоненных заявок в истории.");
                 }
                 else {
-                    std::cout << "Всего отклонено: " << rejected.size() << "\n";
-                    InputUtils::printDivider();
-
-                    for (const auto& record : rejected) {
-                        std::cout << record.toString() << "\n";
-                        InputUtils::printDivider();
-                    }
+                    std::cout << "Всего отклонено: " << rejected << "\n";
+                    printHistoryPages(history, HistoryFilter().withAction(HistoryAction::REJECTED));
                 }
                 InputUtils::waitForEnter("Нажмите Enter для продолжения...");
                 break;
@@ -2124,19 +2154,14 @@ void viewApplicationHistory(const ApplicationHistory& history, UserManager& user
 
             case 4: { 
                 InputUtils::printHeader("УДАЛЕННЫЕ ЗАЯВКИ");
-                auto deleted = history.getRecordsByAction(HistoryAction::DELETED);
+                int deleted = history.getActionCount(HistoryAction::DELETED);
 
-                if (deleted.empty()) {
+                if (deleted == 0) {
                     InputUtils::printInfo("Нет удаленных заявок в истории.");
                 }
                 else {
-                    std::cout << "Всего удалено: " << deleted.size() << "\n";
-                    InputUtils::printDivider();
-
-                    for (const auto& record : deleted) {
-                        std::cout << record.toString() << "\n";
-                        InputUtils::printDivider();
-                    }
+                    std::cout << "Всего удалено: " << deleted << "\n";
+                    printHistoryPages(history, HistoryFilter().withAction(HistoryAction::DELETED));
                 }
                 InputUtils::waitForEnter("Нажмите Enter для продолжения...");
                 break;
@@ -2194,15 +2219,7 @@ void viewApplicationHistory(const ApplicationHistory& history, UserManager& user
                     false
                 );
 
-                // метод поиска
-                auto allRecords = history.getAllRecords();
-                std::vector<HistoryRecord> adminRecords;
-
-                for (const auto& record : allRecords) {
-                    if (record.adminUsername == admin) {
-                        adminRecords.push_back(record);
-                    }
-                }
+                auto adminRecords = history.getRecordsByAdmin(admin);
 
                 if (adminRecords.empty()) {
                     InputUtils::printInfo("Для администратора " + admin + " записей не найдено.");
@@ -2273,24 +2290,21 @@ void viewApplicationHistory(const ApplicationHistory& history, UserManager& user
                     std::cout << "  Удалено: " << deleted << " ("
                         << (deleted * 100 / total) << "%)\n\n";
 
-                    // Получаем топ студентов
-                    auto allRecords = history.getAllRecords();
-                    std::map<std::string, int> studentCount;
-                    for (const auto& record : allRecords) {
-                        studentCount[record.studentUsername]++;
-                    }
-
+                    // Счётчики ведутся историей, первые места берутся готовыми
                     std::cout << "АКТИВНЫЕ СТУДЕНТЫ (по количеству заявок):\n";
-                    std::vector<std::pair<std::string, int>> sortedStudents(
-                        studentCount.begin(), studentCount.end());
-                    std::sort(sortedStudents.begin(), sortedStudents.end(),
-                        [](const auto& a, const auto& b) {
-                            return a.second > b.second;
-                        });
+                    auto topStudents = history.getTopStudents(5);
+                    for (size_t i = 0; i < topStudents.size(); i++) {
+                        std::cout << "  " << (i + 1) << ". " << topStudents[i].first
+                            << " - " << topStudents[i].second << " заявок\n";
+                    }
 
-                    for (int i = 0; i < std::min(5, (int)sortedStudents.size()); i++) {
-                        std::cout << "  " << (i + 1) << ". " << sortedStudents[i].first
-                            << " - " << sortedStudents[i].second << " заявок\n";
+                    auto topAdmins = history.getTopAdmins(5);
+                    if (!topAdmins.empty()) {
+                        std::cout << "\nАКТИВНЫЕ АДМИНИСТРАТОРЫ (по количеству действий):\n";
+                        for (size_t i = 0; i < topAdmins.size(); i++) {
+                            std::cout << "  " << (i + 1) << ". " << topAdmins[i].first
+                                << " - " << topAdmins[i].second << " действий\n";
+                        }
                     }
                 }
                 InputUtils::waitForEnter("Нажмите Enter для продолжения...");
@@ -2301,8 +2315,63 @@ void viewApplicationHistory(const ApplicationHistory& history, UserManager& user
                 SafeExecutor::execute([&]() {
                     InputUtils::printHeader("ЭКСПОРТ ИСТОРИИ В ФАЙЛ");
 
+                    const ExportFormat formats[] = {
+                        ExportFormat::Text, ExportFormat::Csv, ExportFormat::JsonLines
+                    };
+                    int formatChoice = InputValidator::getMenuChoice(
+                        "ФОРМАТ ЭКСПОРТА",
+                        { "Текстовый отчёт", "CSV", "JSON Lines" },
+                        [](int val) { return val >= 1 && val <= 3; },
+                        "Выберите от 1 до 3"
+                    );
+                    ExportFormat format = formats[formatChoice - 1];
+
+                    // Те же условия, что и при просмотре истории
+                    int filterChoice = InputValidator::getMenuChoice(
+                        "КАКИЕ ЗАПИСИ ВЫГРУЗИТЬ",
+                        { "Всю историю", "Одобренные заявки", "Отклоненные заявки",
+                          "Удаленные заявки", "Записи студента", "Действия администратора",
+                          "За последние N дней" },
+                        [](int val) { return val >= 1 && val <= 7; },
+                        "Выберите от 1 до 7"
+                    );
+
+                    HistoryFilter filter;
+                    switch (filterChoice) {
+                    case 2: filter.withAction(HistoryAction::APPROVED); break;
+                    case 3: filter.withAction(HistoryAction::REJECTED); break;
+                    case 4: filter.withAction(HistoryAction::DELETED); break;
+                    case 5:
+                        filter.withStudent(InputValidator::getStringInput(
+                            "Введите логин студента: ",
+                            Validators::validateUsername,
+                            "Логин должен быть от 3 до 20 символов",
+                            false
+                        ));
+                        break;
+                    case 6:
+                        filter.withAdmin(InputValidator::getStringInput(
+                            "Введите логин администратора: ",
+                            Validators::validateUsername,
+                            "Логин должен быть от 3 до 20 символов",
+                            false
+                        ));
+                        break;
+                    case 7: {
+                        int days = InputValidator::getIntInput(
+                            "Количество дней: ",
+                            [](int val) { return val >= 1 && val <= 3650; },
+                            "Количество дней должно быть от 1 до 3650"
+                        );
+                        std::time_t now = std::time(nullptr);
+                        filter.between(now - static_cast<std::time_t>(days) * 24 * 60 * 60, now);
+                        break;
+                    }
+                    }
+
                     std::string filename = InputValidator::getStringInput(
-                        "Введите имя файла (например: history_export.txt): ",
+                        "Введите имя файла (например: history_export" +
+                        HistoryExporter::defaultExtension(format) + "): ",
                         [](const std::string& name) {
                             if (name.empty()) return false;
                             if (name.find('/') != std::string::npos ||
@@ -2322,35 +2391,52 @@ void viewApplicationHistory(const ApplicationHistory& history, UserManager& user
                         false
                     );
 
-                    auto allRecords = history.getAllRecords();
-                    std::ofstream file(filename);
-
-                    if (!file.is_open()) {
-                        throw std::runtime_error("Не удалось создать файл!");
-                    }
-
-                    file << "ЭКСПОРТ ИСТОРИИ ЗАЯВОК НА СТИПЕНДИИ\n";
-                    file << "Дата экспорта: ";
+                    size_t exported = HistoryExporter::exportToFile(history, filename, format, filter);
+                    InputUtils::printSuccess("Экспортировано записей: " + std::to_string(exported) +
+                        " (" + HistoryExporter::formatName(format) + ") в файл: " + filename);
+                    }, "экспорта истории");
+                InputUtils::waitForEnter("Нажмите Enter для продолжения...");
+                break;
+            }
 
-                    auto now = std::chrono::system_clock::now();
-                    auto now_time = std::chrono::system_clock::to_time_t(now);
+            case 10: {  // Агрегаты по дням, неделям и семестрам
+                int period = InputValidator::getMenuChoice(
+                    "АНАЛИТИКА ПО ПЕРИОДАМ",
+                    { "По дням", "По неделям", "По семестрам" },
+                    [](int val) { return val >= 1 && val <= 3; },
+                    "Выберите от 1 до 3"
+                );
+                int grouping = InputValidator::getMenuChoice(
+                    "РАЗБИВКА ВНУТРИ ПЕРИОДА",
+                    { "Без разбивки", "По действиям", "По видам стипендий", "По администраторам" },
+                    [](int val) { return val >= 1 && val <= 4; },
+                    "Выберите от 1 до 4"
+                );
 
-                    char timeStr[26];
-                    ctime_s(timeStr, sizeof(timeStr), &now_time);
-                    file << timeStr << "\n";
+                const RollupGranularity granularities[] = {
+                    RollupGranularity::Day, RollupGranularity::Week, RollupGranularity::Semester
+                };
+                const RollupGroup groups[] = {
+                    RollupGroup::None, RollupGroup::Action,
+                    RollupGroup::ScholarshipType, RollupGroup::Admin
+                };
 
-                    file << "========================================\n\n";
+                // Счётчики ведутся историей, записи при этом не читаются
+                auto rows = history.queryRollup(granularities[period - 1],
+                    0, std::time(nullptr), RollupFilter(), groups[grouping - 1]);
 
-                    for (const auto& record : allRecords) {
-                        file << record.toString() << "\n";
-                        file << "----------------------------------------\n";
+                if (rows.empty()) {
+                    InputUtils::printInfo("История пуста.");
+                }
+                else {
+                    for (const auto& row : rows) {
+                        std::cout << "  " << std::left << std::setw(22) << row.label;
+                        if (!row.group.empty()) {
+                            std::cout << std::setw(24) << row.group;
+                        }
+                        std::cout << std::right << row.count << "\n";
                     }
-
-                    file << "\nИТОГО: " << allRecords.size() << " записей\n";
-
-                    file.close();
-                    InputUtils::printSuccess("История экспортирована в файл: " + filename);
-                    }, "экспорта истории");
+                }
                 InputUtils::waitForEnter("Нажмите Enter для продолжения...");
                 break;
             }
@@ -2402,6 +2488,7 @@ void studentManagementMenu(UserManager& userManager,
                 SafeExecutor::execute([&]() {
                     InputUtils::printHeader("Все студенты (краткая информация)");
 
+                    // Копия: список сортируется ниже
                     auto students = userManager.getAllStudents();
                     if (students.empty()) {
                         InputUtils::printInfo("В системе нет студентов.");
@@ -2448,13 +2535,12 @@ void studentManagementMenu(UserManager& userManager,
                 SafeExecutor::execute([&]() {
                     InputUtils::printHeader("Студенты со стипендией");
 
-                    auto students = userManager.getAllStudents();
+                    // Отбор по колонке флагов; строка таблицы = индекс в списке студентов
+                    const auto& students = userManager.getAllStudents();
                     std::vector<std::shared_ptr<Student>> scholarshipStudents;
 
-                    for (const auto& stu : students) {
-                        if (stu->getHasScholarship()) {
-                            scholarshipStudents.push_back(stu);
-                        }
+                    for (uint32_t row : userManager.getStudentTable().scholarshipRows()) {
+                        scholarshipStudents.push_back(students[row]);
                     }
 
                     if (scholarshipStudents.empty()) {
@@ -2519,7 +2605,7 @@ void studentManagementMenu(UserManager& userManager,
                         );
 
                         auto user = userManager.findUser(searchTerm);
-                        if (user && user->getRole() == "student") {
+                        if (user && user->isStudent()) {
                             foundStudents.push_back(std::static_pointer_cast<Student>(user));
                         }
                         break;
@@ -2534,7 +2620,7 @@ void studentManagementMenu(UserManager& userManager,
                             100
                         );
 
-                        auto students = userManager.getAllStudents();
+                        const auto& students = userManager.getAllStudents();
                         for (const auto& stu : students) {
                             if (stu->getFio().find(searchTerm) != std::string::npos) {
                                 foundStudents.push_back(stu);
@@ -2552,7 +2638,7 @@ void studentManagementMenu(UserManager& userManager,
                             20
                         );
 
-                        auto students = userManager.getAllStudents();
+                        const auto& students = userManager.getAllStudents();
                         for (const auto& stu : students) {
                             if (stu->getGroup().find(searchTerm) != std::string::npos) {
                                 foundStudents.push_back(stu);
@@ -2615,7 +2701,7 @@ void studentManagementMenu(UserManager& userManager,
                     );
 
                     auto user = userManager.findUser(username);
-                    if (!user || user->getRole() != "student") {
+                    if (!user || !user->isStudent()) {
                         throw std::runtime_error("Студент не найден!");
                     }
 
@@ -2684,44 +2770,21 @@ void studentManagementMenu(UserManager& userManager,
                 SafeExecutor::execute([&]() {
                     InputUtils::printHeader("Статистика по студентам");
 
-                    auto students = userManager.getAllStudents();
-                    if (students.empty()) {
+                    // Считается по колонкам таблицы студентов, без обхода объектов
+                    const StudentTable& table = userManager.getStudentTable();
+                    if (table.size() == 0) {
                         InputUtils::printInfo("Нет студентов для анализа.");
                         return;
                     }
 
-                    int totalStudents = static_cast<int>(students.size());
-                    int budgetStudents = 0, paidStudents = 0;
-                    int scholarshipStudents = 0;
-                    int byCourse[4] = { 0, 0, 0, 0 };
-                    double totalAverage = 0.0;
-
-                    // Статистика по факультетам
-                    std::map<std::string, int> facultyCount;
-                    std::map<std::string, double> facultyAverage;
-
-                    for (const auto& stu : students) {
-                        // Форма обучения
-                        if (stu->getStudyForm() == StudyForm::Budget) budgetStudents++;
-                        else paidStudents++;
-
-                        // Стипендия
-                        if (stu->getHasScholarship()) scholarshipStudents++;
-
-                        // Курс
-                        int course = stu->getCourse() - 1;
-                        if (course >= 0 && course < 4) {
-                            byCourse[course]++;
-                        }
-
-                        // Факультеты
-                        std::string faculty = stu->getFaculty();
-                        if (faculty.empty()) faculty = "Не указан";
-                        facultyCount[faculty]++;
-                        facultyAverage[faculty] += stu->getAverageGrade();
+                    const StudentTable::Summary summary = table.summarize();
+                    const std::vector<size_t> byCourse = table.courseHistogram(4);
 
-                        totalAverage += stu->getAverageGrade();
-                    }
+                    int totalStudents = static_cast<int>(summary.total);
+                    int budgetStudents = static_cast<int>(summary.budget);
+                    int paidStudents = totalStudents - budgetStudents;
+                    int scholarshipStudents = static_cast<int>(summary.scholarship);
+                    double totalAverage = summary.gradeSum;
 
                     std::cout << "ОБЩАЯ СТАТИСТИКА:\n";
                     std::cout << "  Всего студентов: " << totalStudents << "\n";
@@ -2742,10 +2805,11 @@ void studentManagementMenu(UserManager& userManager,
                     std::cout << "\n";
 
                     std::cout << "РАСПРЕДЕЛЕНИЕ ПО ФАКУЛЬТЕТАМ:\n";
-                    for (const auto& [faculty, count] : facultyCount) {
-                        double avg = facultyAverage[faculty] / count;
-                        std::cout << "  " << faculty << ": " << count << " студентов ("
-                            << (count * 100 / totalStudents) << "%), Средний балл: "
+                    for (const auto& faculty : table.facultyStats()) {
+                        double avg = faculty.gradeSum / faculty.count;
+                        std::cout << "  " << (faculty.name.empty() ? "Не указан" : faculty.name)
+                            << ": " << faculty.count << " студентов ("
+                            << (faculty.count * 100 / totalStudents) << "%), Средний балл: "
                             << avg << "/10.0\n";
                     }
                     }, "статистики по студентам");
@@ -2771,11 +2835,127 @@ void studentManagementMenu(UserManager& userManager,
     }
 }
 
-int main() {
+// Числовой аргумент командной строки или значение по умолчанию
+static int argOrDefault(int argc, char* argv[], int index, int defaultValue) {
+    int value = defaultValue;
+    if (index < argc && !Utils::parseInt(argv[index], value)) {
+        value = defaultValue;
+    }
+    return value;
+}
+
+// Project2 --server [порт] [потоков]
+int runServerMode(int argc, char* argv[]) {
+    int port = argOrDefault(argc, argv, 2, 5050);
+    int threads = argOrDefault(argc, argv, 3,
+        static_cast<int>(std::max(4u, std::thread::hardware_concurrency() * 2)));
+
+    UserManager userManager;
+    ScholarshipTypeManager scholarshipManager;
+    ApplicationManager appManager;
+    SecurityManager security("config.txt");
+    security.ensureDefaultMaster();
+    Logger::flush();
+
+    SessionServer server(userManager, appManager, scholarshipManager, security,
+        port, static_cast<size_t>(threads));
+    if (!server.start()) {
+        InputUtils::printError("Не удалось открыть порт " + std::to_string(port));
+        return 1;
+    }
+
+    InputUtils::printSuccess("Сервер запущен на 127.0.0.1:" + std::to_string(port) +
+        ", потоков: " + std::to_string(threads));
+    InputUtils::printInfo("Нажмите Enter для остановки сервера.");
+    std::string line;
+    std::getline(std::cin, line);
+
+    server.stop();
+    std::cout << "Обработано запросов: " << server.getRequestCount() << "\n";
+    handleExit(userManager, appManager, scholarshipManager);
+    return 0;
+}
+
+// Project2 --loadgen [порт] [клиентов] [запросов] [логин] [пароль] [мастер-пароль] [процент записей]
+int runLoadGenerator(int argc, char* argv[]) {
+    LoadGeneratorConfig config;
+    config.port = argOrDefault(argc, argv, 2, config.port);
+    config.clients = argOrDefault(argc, argv, 3, config.clients);
+    config.requestsPerClient = argOrDefault(argc, argv, 4, config.requestsPerClient);
+    config.username = argc > 5 ? argv[5] : "";
+    config.password = argc > 6 ? argv[6] : "";
+    config.masterPassword = argc > 7 ? argv[7] : "";
+    config.writePercent = argOrDefault(argc, argv, 8, config.writePercent);
+
+    if (config.username.empty() || config.password.empty()) {
+        InputUtils::printError("Укажите логин и пароль: --loadgen <порт> <клиентов> <запросов> <логин> <пароль>");
+        return 1;
+    }
+
+    LoadGeneratorReport report = LoadGenerator::run(config);
+    LoadGenerator::printReport(config, report);
+    return report.requests > 0 ? 0 : 1;
+}
+
+// Журнал меню по умолчанию (см. applyLogOptions)
+static const char* DEFAULT_LOG_FILE = "scholarship.log";
+
+// Разбирает --log-level=<debug|info|warn|error|off> и --log-file=<путь> в любом
+// месте командной строки и возвращает остальные аргументы (с nullptr в конце,
+// как argv). Без --log-file меню пишет журнал в DEFAULT_LOG_FILE, чтобы строки
+// фонового вывода не вклинивались в экран; сервер и генератор нагрузки - в
+// stderr. "--log-file=" без пути - stderr и для меню
+static std::vector<char*> applyLogOptions(int argc, char* argv[]) {
+    std::vector<char*> rest;
+    std::string logFile;
+    bool fileGiven = false;
+    for (int i = 0; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.rfind("--log-level=", 0) == 0) {
+            LogLevel level;
+            if (Logger::parseLevel(arg.substr(12), level)) {
+                Logger::setLevel(level);
+            }
+            else {
+                std::cerr << "Неизвестный уровень журнала: " << arg.substr(12) << "\n";
+            }
+            continue;
+        }
+        if (arg.rfind("--log-file=", 0) == 0) {
+            logFile = std::string(arg.substr(11));
+            fileGiven = true;
+            continue;
+        }
+        rest.push_back(argv[i]);
+    }
+
+    bool menu = rest.size() < 2 ||
+        (std::string_view(rest[1]) != "--server" && std::string_view(rest[1]) != "--loadgen");
+    if (!fileGiven && menu) logFile = DEFAULT_LOG_FILE;
+    if (!logFile.empty() && !Logger::setOutput(logFile)) {
+        std::cerr << "Не удалось открыть файл журнала " << logFile << ", вывод в stderr\n";
+    }
+    rest.push_back(nullptr);
+    return rest;
+}
+
+// Project2 [--server ... | --loadgen ...] [--log-level=<уровень>] [--log-file=<путь>]
+int main(int argc, char* argv[]) {
     SetConsoleCP(1251);
     SetConsoleOutputCP(1251);
     setlocale(LC_ALL, "Russian");
 
+    std::vector<char*> args = applyLogOptions(argc, argv);
+    argc = static_cast<int>(args.size()) - 1;
+    argv = args.data();
+
+    if (argc > 1 && std::string(argv[1]) == "--server") {
+        return runServerMode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--loadgen") {
+        return runLoadGenerator(argc, argv);
+    }
+
     std::set_terminate([]() {
         InputUtils::printError("Необработанное исключение! Программа будет завершена.");
         std::exit(1);
@@ -2789,6 +2969,8 @@ int main() {
         SafeExecutor::execute([&security]() {
             security.ensureDefaultMaster();
             }, "инициализации безопасности");
+        // Сообщения загрузки выводятся до первого меню
+        Logger::flush();
 
         bool running = true;
 